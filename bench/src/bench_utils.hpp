@@ -0,0 +1,17 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Report the throughput of a benchmark that processes num_frames frames of
+ * num_channels channels per iteration as samples/s, and its cost as time/frame
+ */
+inline void set_frame_counters(benchmark::State& state, const size_t num_frames, const size_t num_channels) {
+	const double frames = static_cast<double>(state.iterations()) * static_cast<double>(num_frames);
+
+	state.counters["samples/s"] = benchmark::Counter(frames * static_cast<double>(num_channels),
+	                                                 benchmark::Counter::kIsRate);
+	state.counters["time/frame"] = benchmark::Counter(frames, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
@@ -0,0 +1,95 @@
+#include <vector>
+
+#include <stac_audio/block_ops.hpp>
+
+#include "bench_utils.hpp"
+
+namespace {
+using frame_type = dsp::Frame<dsp::sample_t>;
+
+constexpr size_t BLOCK_FRAMES = 4096;
+
+dsp::PlanarSignal<dsp::sample_t> make_signal(const size_t num_channels, const size_t num_frames) {
+	dsp::PlanarSignal<dsp::sample_t> signal(dsp::SAMPLE_RATE, num_channels, num_frames);
+
+	for (auto& channel : signal.channels) {
+		for (size_t i = 0; i < num_frames; i++) {
+			channel[i] = static_cast<dsp::sample_t>(i % 100) * 0.01f;
+		}
+	}
+
+	return signal;
+}
+
+void BM_ReadWrapped(benchmark::State& state) {
+	const size_t num_channels = static_cast<size_t>(state.range(0));
+	// not a multiple of the block, so that reads wrap around
+	const dsp::PlanarSignal<dsp::sample_t> signal = make_signal(num_channels, 10007);
+	std::vector<frame_type> frames(BLOCK_FRAMES);
+	size_t position = 0;
+
+	for (auto _ : state) {
+		position = dsp::read_wrapped(signal, position, std::span<frame_type>(frames));
+		benchmark::DoNotOptimize(frames.data());
+		benchmark::ClobberMemory();
+	}
+
+	set_frame_counters(state, BLOCK_FRAMES, dsp::NUM_CHANNELS);
+}
+
+void BM_ApplyGain(benchmark::State& state) {
+	std::vector<frame_type> frames(BLOCK_FRAMES, frame_type(0.5f, 0.25f));
+	// the gains are exact and cancel out, so the samples never drift into denormals
+	bool boost = true;
+
+	for (auto _ : state) {
+		dsp::apply_gain(std::span<frame_type>(frames), boost ? 2.0f : 0.5f);
+		boost = !boost;
+		benchmark::DoNotOptimize(frames.data());
+		benchmark::ClobberMemory();
+	}
+
+	set_frame_counters(state, BLOCK_FRAMES, dsp::NUM_CHANNELS);
+}
+
+void BM_WriteInterleaved(benchmark::State& state) {
+	const size_t out_channels = static_cast<size_t>(state.range(0));
+	const std::vector<frame_type> frames(BLOCK_FRAMES, frame_type(0.5f, 0.25f));
+	std::vector<dsp::sample_t> out(BLOCK_FRAMES * out_channels);
+
+	for (auto _ : state) {
+		dsp::write_interleaved(std::span<const frame_type>(frames), out.data(), out_channels);
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+
+	set_frame_counters(state, BLOCK_FRAMES, out_channels);
+}
+
+void BM_WriteInterleavedSmoothedGain(benchmark::State& state) {
+	const bool ramping = state.range(0) != 0;
+	const std::vector<frame_type> frames(BLOCK_FRAMES, frame_type(0.5f, 0.25f));
+	std::vector<dsp::sample_t> out(BLOCK_FRAMES * dsp::NUM_CHANNELS);
+	// a ramp as long as the block, so that every frame is ramped when ramping
+	dsp::SmoothedValue<dsp::amplitude_t> gain(1.0f, BLOCK_FRAMES);
+	dsp::amplitude_t target = 0.0f;
+
+	for (auto _ : state) {
+		if (ramping) {
+			gain.set_target(target);
+			target = 1.0f - target;
+		}
+
+		dsp::write_interleaved(std::span<const frame_type>(frames), out.data(), dsp::NUM_CHANNELS, gain);
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+
+	set_frame_counters(state, BLOCK_FRAMES, dsp::NUM_CHANNELS);
+}
+}
+
+BENCHMARK(BM_ReadWrapped)->ArgName("channels")->Arg(1)->Arg(2);
+BENCHMARK(BM_ApplyGain);
+BENCHMARK(BM_WriteInterleaved)->ArgName("out_channels")->Arg(1)->Arg(2)->Arg(6);
+BENCHMARK(BM_WriteInterleavedSmoothedGain)->ArgName("ramping")->Arg(0)->Arg(1);
@@ -0,0 +1,121 @@
+#include <memory>
+#include <vector>
+
+#include <stac_audio/audio_engine.hpp>
+#include <stac_audio/biquad.hpp>
+
+#include "bench_utils.hpp"
+
+namespace {
+/**
+ * @brief Backend that only calls back when asked to, so that a benchmark may time
+ * the engine's callback on its own thread
+ */
+class ManualBackend : public AudioBackend {
+private:
+	AudioStreamConfig  config;
+	PaStreamCallback*  callback  = nullptr;
+	void*              user_data = nullptr;
+	std::vector<float> buffer;
+
+public:
+	bool open(const AudioStreamConfig& config, PaStreamCallback* callback,
+	          PaStreamFinishedCallback* finished_callback, void* user_data) override {
+		(void)finished_callback;
+
+		this->config = config;
+		this->callback = callback;
+		this->user_data = user_data;
+		this->buffer.assign(config.frames_per_buffer * config.num_channels, dsp::SAMPLE_SILENCE);
+
+		return true;
+	}
+
+	bool start() override {
+		return this->callback != nullptr;
+	}
+
+	void stop() override { }
+
+	void close() override {
+		this->callback = nullptr;
+	}
+
+	bool is_active() const override {
+		return this->callback != nullptr;
+	}
+
+	PaError get_last_error() const override {
+		return paNoError;
+	}
+
+	int32_t render() {
+		const PaStreamCallbackTimeInfo time_info = { };
+
+		return this->callback(nullptr, this->buffer.data(), this->config.frames_per_buffer, &time_info, 0, this->user_data);
+	}
+
+	const float* data() const {
+		return this->buffer.data();
+	}
+};
+
+void BM_Callback(benchmark::State& state) {
+	const size_t frames_per_buffer = static_cast<size_t>(state.range(0));
+	const bool with_effects = state.range(1) != 0;
+	dsp::PlanarSignal<dsp::sample_t> signal(dsp::SAMPLE_RATE, 2, 10 * dsp::SAMPLE_RATE);
+
+	for (auto& channel : signal.channels) {
+		for (size_t i = 0; i < channel.size(); i++) {
+			channel[i] = static_cast<dsp::sample_t>(i % 100) * 0.01f;
+		}
+	}
+
+	auto backend = std::make_unique<ManualBackend>();
+	ManualBackend& manual_backend = *backend;
+	AudioEngine engine(std::move(backend));
+	AudioEngine::Config config;
+
+	config.frames_per_buffer = frames_per_buffer;
+	// measured by the benchmark instead
+	config.collect_telemetry = false;
+
+	if (!engine.open(&signal, config) || !engine.start()) {
+		state.SkipWithError("Unable to open the engine");
+		return;
+	}
+
+	if (with_effects) {
+		auto chain = std::make_unique<EffectChain<dsp::sample_t>>();
+
+		chain->add(std::make_shared<ProcessorEffect<dsp::Biquad<dsp::sample_t>>>(
+			dsp::BiquadType::HIGH_PASS, dsp::SAMPLE_RATE, 20.0f, 0.707, 0.0));
+		chain->add(std::make_shared<ProcessorEffect<dsp::Biquad<dsp::sample_t>>>(
+			dsp::BiquadType::PEAK, dsp::SAMPLE_RATE, 1000.0f, 1.0, 3.0));
+		engine.get_effects().submit(std::move(chain));
+	}
+
+	lfmq::Message msg;
+
+	msg.set_metadata(lfmq::MessageMetadata(lfmq::MessageType::PLAY_AT));
+	msg.set_payload(static_cast<dsp::time_ms_t>(0));
+	engine.send(msg);
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(manual_backend.render());
+		benchmark::DoNotOptimize(manual_backend.data());
+	}
+
+	set_frame_counters(state, frames_per_buffer, config.num_channels);
+	// share of the buffer period spent in the callback, i.e. the cost of one stream on one core
+	state.counters["load"] = benchmark::Counter(
+		static_cast<double>(state.iterations()) * static_cast<double>(frames_per_buffer) / dsp::SAMPLE_RATE,
+		benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+
+	engine.close();
+}
+}
+
+BENCHMARK(BM_Callback)
+	->ArgNames({ "frames_per_buffer", "effects" })
+	->ArgsProduct({ { 64, 128, 256, 512, 1024 }, { 0, 1 } });
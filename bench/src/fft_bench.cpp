@@ -0,0 +1,62 @@
+#include <algorithm>
+#include <complex>
+#include <vector>
+#include <cmath>
+
+#include <stac_audio/dsp_declarations.hpp>
+#include <stac_audio/fft_converter.hpp>
+
+#include "bench_utils.hpp"
+
+namespace {
+using Converter = FFTConverter<dsp::sample_t>;
+
+std::vector<dsp::sample_t> make_block(const size_t num_samples) {
+	std::vector<dsp::sample_t> samples(num_samples);
+
+	for (size_t i = 0; i < num_samples; i++) {
+		samples[i] = std::sin(static_cast<dsp::sample_t>(i) * 0.05f);
+	}
+
+	return samples;
+}
+
+void BM_FFTForward(benchmark::State& state) {
+	const size_t n = static_cast<size_t>(state.range(0));
+	const Converter converter(Converter::AllocationStrategy::IMPATIENT, n, true);
+	const std::vector<dsp::sample_t> real_samples = make_block(n);
+	std::vector<Converter::complex_type> complex_samples(n / 2 + 1);
+
+	for (auto _ : state) {
+		converter.forward(real_samples.data(), complex_samples.data());
+		benchmark::DoNotOptimize(complex_samples.data());
+		benchmark::ClobberMemory();
+	}
+
+	set_frame_counters(state, n, 1);
+}
+
+void BM_FFTInverse(benchmark::State& state) {
+	const size_t n = static_cast<size_t>(state.range(0));
+	const Converter converter(Converter::AllocationStrategy::IMPATIENT, n, true);
+	const std::vector<dsp::sample_t> real_samples = make_block(n);
+	std::vector<Converter::complex_type> spectrum(n / 2 + 1);
+	std::vector<Converter::complex_type> complex_samples(n / 2 + 1);
+	std::vector<dsp::sample_t> output(n);
+
+	converter.forward(real_samples.data(), spectrum.data());
+
+	// includes copying the spectrum, which the inverse transform overwrites
+	for (auto _ : state) {
+		std::copy(spectrum.begin(), spectrum.end(), complex_samples.begin());
+		converter.inverse(complex_samples.data(), output.data());
+		benchmark::DoNotOptimize(output.data());
+		benchmark::ClobberMemory();
+	}
+
+	set_frame_counters(state, n, 1);
+}
+}
+
+BENCHMARK(BM_FFTForward)->RangeMultiplier(2)->Range(256, 8192);
+BENCHMARK(BM_FFTInverse)->RangeMultiplier(2)->Range(256, 8192);
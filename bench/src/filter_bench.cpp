@@ -0,0 +1,70 @@
+#include <vector>
+#include <cmath>
+
+#include <stac_audio/biquad.hpp>
+#include <stac_audio/equalizer.hpp>
+
+#include "bench_utils.hpp"
+
+namespace {
+constexpr size_t BLOCK_FRAMES = 4096;
+
+std::vector<dsp::Frame<dsp::sample_t>> make_frames(const size_t num_frames) {
+	std::vector<dsp::Frame<dsp::sample_t>> frames(num_frames);
+
+	for (size_t i = 0; i < num_frames; i++) {
+		const dsp::sample_t value = std::sin(static_cast<dsp::sample_t>(i) * 0.05f);
+
+		frames[i] = dsp::Frame<dsp::sample_t>(value, -value);
+	}
+
+	return frames;
+}
+
+void BM_BiquadBlock(benchmark::State& state) {
+	dsp::Biquad<dsp::sample_t> biquad(dsp::BiquadType::LOW_PASS, dsp::SAMPLE_RATE, 1000.0f, 0.707, 0.0);
+	std::vector<dsp::Frame<dsp::sample_t>> frames = make_frames(BLOCK_FRAMES);
+
+	for (auto _ : state) {
+		biquad.process(std::span<dsp::Frame<dsp::sample_t>>(frames));
+		benchmark::DoNotOptimize(frames.data());
+		benchmark::ClobberMemory();
+	}
+
+	set_frame_counters(state, BLOCK_FRAMES, dsp::NUM_CHANNELS);
+}
+
+void BM_BiquadPlanarChannel(benchmark::State& state) {
+	dsp::Biquad<dsp::sample_t> biquad(dsp::BiquadType::LOW_PASS, dsp::SAMPLE_RATE, 1000.0f, 0.707, 0.0);
+	std::vector<dsp::sample_t> samples(BLOCK_FRAMES, 0.25f);
+
+	for (auto _ : state) {
+		biquad.process(std::span<dsp::sample_t>(samples), 0);
+		benchmark::DoNotOptimize(samples.data());
+		benchmark::ClobberMemory();
+	}
+
+	set_frame_counters(state, BLOCK_FRAMES, 1);
+}
+
+void BM_EqualizerBlock(benchmark::State& state) {
+	static constexpr size_t MAX_BANDS = 31;
+	const size_t num_bands = static_cast<size_t>(state.range(0));
+	dsp::Equalizer<dsp::sample_t, MAX_BANDS> equalizer(dsp::SAMPLE_RATE);
+	std::vector<dsp::Frame<dsp::sample_t>> frames = make_frames(BLOCK_FRAMES);
+
+	equalizer.configure_graphic(num_bands, 20.0, 20000.0);
+
+	for (auto _ : state) {
+		equalizer.process(std::span<dsp::Frame<dsp::sample_t>>(frames));
+		benchmark::DoNotOptimize(frames.data());
+		benchmark::ClobberMemory();
+	}
+
+	set_frame_counters(state, BLOCK_FRAMES, dsp::NUM_CHANNELS);
+}
+}
+
+BENCHMARK(BM_BiquadBlock);
+BENCHMARK(BM_BiquadPlanarChannel);
+BENCHMARK(BM_EqualizerBlock)->ArgName("bands")->Arg(5)->Arg(10)->Arg(31);
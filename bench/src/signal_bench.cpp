@@ -0,0 +1,114 @@
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <cmath>
+#include <sndfile.h>
+
+#include <stac_audio/audio_file.hpp>
+
+#include "bench_utils.hpp"
+
+namespace {
+constexpr size_t FILE_FRAMES   = 10 * dsp::SAMPLE_RATE;
+constexpr size_t FILE_CHANNELS = 2;
+
+/**
+ * @return Path of a 10 second stereo float WAV file, which is written on first use,
+ * or an empty path if it could not be written
+ */
+const std::string& bench_file_path() {
+	static const std::string file_path = [] {
+		const std::filesystem::path path = std::filesystem::temp_directory_path() / "stac_audio_bench.wav";
+		SF_INFO sf_info = { };
+
+		sf_info.samplerate = static_cast<int>(dsp::SAMPLE_RATE);
+		sf_info.channels = static_cast<int>(FILE_CHANNELS);
+		sf_info.format = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+
+		SNDFILE* sf = sf_open(path.string().c_str(), SFM_WRITE, &sf_info);
+
+		if (sf == nullptr) {
+			return std::string();
+		}
+
+		std::vector<float> samples(FILE_FRAMES * FILE_CHANNELS);
+
+		for (size_t i = 0; i < samples.size(); i++) {
+			samples[i] = 0.5f * std::sin(static_cast<float>(i) * 0.01f);
+		}
+
+		const sf_count_t frames_written = sf_writef_float(sf, samples.data(), static_cast<sf_count_t>(FILE_FRAMES));
+
+		// a truncated file would be loaded and measured as if it were whole
+		if (sf_close(sf) != 0 || frames_written != static_cast<sf_count_t>(FILE_FRAMES)) {
+			std::error_code error;
+
+			std::filesystem::remove(path, error);
+
+			return std::string();
+		}
+
+		return path.string();
+	}();
+
+	return file_path;
+}
+
+/**
+ * @brief  Read every sample of a loaded file, so that a mapped file is paged in just
+ * as a decoded file is written
+ * @return Sum of the samples
+ */
+double sum_samples(const AudioFile& audio_file) {
+	double sum = 0.0;
+
+	if (audio_file.is_memory_mapped()) {
+		const dsp::SignalView<dsp::sample_t>& view = audio_file.get_view();
+
+		for (size_t i = 0; i < view.num_frames * view.num_channels; i++) {
+			sum += view.samples[i];
+		}
+	} else {
+		for (const auto& channel : audio_file.get_signal().channels) {
+			for (const dsp::sample_t sample : channel) {
+				sum += sample;
+			}
+		}
+	}
+
+	return sum;
+}
+
+/**
+ * @brief Load the file and read every sample of it. Reading the samples is what makes
+ * the mapped case comparable to the decoded one, since mapping alone only parses the header
+ */
+void BM_AudioFileLoad(benchmark::State& state) {
+	const AudioFile::LoadMode mode = static_cast<AudioFile::LoadMode>(state.range(0));
+	const std::string& file_path = bench_file_path();
+	AudioFile audio_file;
+
+	if (file_path.empty()) {
+		state.SkipWithError("Unable to write the benchmark file");
+		return;
+	}
+
+	for (auto _ : state) {
+		if (!audio_file.load(file_path, mode)) {
+			state.SkipWithError("Unable to load the benchmark file");
+			return;
+		}
+
+		benchmark::DoNotOptimize(sum_samples(audio_file));
+	}
+
+	set_frame_counters(state, FILE_FRAMES, FILE_CHANNELS);
+}
+}
+
+BENCHMARK(BM_AudioFileLoad)
+	->ArgName("memory_mapped")
+	->Arg(static_cast<int64_t>(AudioFile::LoadMode::DECODE))
+	->Arg(static_cast<int64_t>(AudioFile::LoadMode::MEMORY_MAPPED))
+	->Unit(benchmark::kMillisecond);
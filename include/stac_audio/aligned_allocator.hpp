@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <limits>
+
+namespace dsp {
+/// Default alignment, in bytes, of buffers that are handed to SIMD kernels and fftw
+constexpr std::size_t DEFAULT_BUFFER_ALIGNMENT = 64;
+
+/**
+ * @brief Allocator that returns memory aligned to _alignment bytes so that
+ * per-channel buffers may be used directly with SIMD loads and fftw plans
+ */
+template<typename _value_t, std::size_t _alignment = DEFAULT_BUFFER_ALIGNMENT>
+class AlignedAllocator {
+public:
+	using value_type = _value_t;
+
+	static_assert(_alignment >= alignof(_value_t), "Alignment must be at least the alignment of the value type");
+	static_assert((_alignment & (_alignment - 1)) == 0, "Alignment must be a power of two");
+
+	template<typename _other_t>
+	struct rebind {
+		using other = AlignedAllocator<_other_t, _alignment>;
+	};
+
+	constexpr AlignedAllocator() noexcept = default;
+
+	template<typename _other_t>
+	constexpr AlignedAllocator(const AlignedAllocator<_other_t, _alignment>&) noexcept
+	{ }
+
+	[[nodiscard]] _value_t* allocate(const std::size_t n) {
+		if (n > std::numeric_limits<std::size_t>::max() / sizeof(_value_t)) {
+			throw std::bad_array_new_length();
+		}
+
+		return static_cast<_value_t*>(::operator new(n * sizeof(_value_t), std::align_val_t(_alignment)));
+	}
+
+	void deallocate(_value_t* const ptr, const std::size_t) noexcept {
+		::operator delete(ptr, std::align_val_t(_alignment));
+	}
+
+	template<typename _other_t>
+	constexpr bool operator==(const AlignedAllocator<_other_t, _alignment>&) const noexcept {
+		return true;
+	}
+};
+} // namespace dsp
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <portaudio.h>
+#include <sndfile.h>
+
+#include "dsp_declarations.hpp"
+
+/**
+ * @brief Parameters of the output stream opened by an AudioBackend
+ */
+struct AudioStreamConfig {
+	dsp::sample_rate_t sample_rate       = dsp::SAMPLE_RATE;
+	/// Frames per callback. 0 lets the backend choose
+	size_t             frames_per_buffer = dsp::FRAMES_PER_BUFFER;
+	/// Number of interleaved float channels of the output buffer
+	size_t             num_channels      = dsp::NUM_CHANNELS;
+	/// Output device of backends that have devices. paNoDevice uses the default device
+	PaDeviceIndex      device            = paNoDevice;
+	/// Suggested output latency in seconds. 0 uses the device's default low latency
+	PaTime             suggested_latency = 0.0;
+};
+
+/**
+ * @brief Output stream that calls back for audio, e.g. a sound card through
+ * PortAudio, or no device at all for testing and benchmarking on machines without
+ * sound hardware. Every backend uses PortAudio's callback signatures and return
+ * values, so a callback runs unchanged on any of them.
+ */
+class AudioBackend {
+public:
+	virtual ~AudioBackend() = default;
+
+	/**
+	 * @brief  Open a stream that calls callback for every buffer once it is started
+	 * @param  config Parameters of the stream
+	 * @param  callback Fills an interleaved float output buffer. Returns paContinue,
+	 * paComplete to stop after the buffer has played, or paAbort
+	 * @param  finished_callback Called once the stream has become inactive. May be null
+	 * @param  user_data Passed to both callbacks
+	 * @return Whether the stream was able to be opened
+	 */
+	virtual bool open(const AudioStreamConfig& config, PaStreamCallback* callback,
+	                  PaStreamFinishedCallback* finished_callback, void* user_data) = 0;
+	virtual bool start() = 0;
+	/**
+	 * @brief Stop the stream once the buffers that were already queued have played
+	 */
+	virtual void stop() = 0;
+	/**
+	 * @brief Close the stream, aborting it first if it is running
+	 */
+	virtual void close() = 0;
+	virtual bool is_active() const = 0;
+	/**
+	 * @return Last error returned by PortAudio. paNoError for backends without PortAudio
+	 */
+	virtual PaError get_last_error() const = 0;
+};
+
+/**
+ * @brief Plays through a sound card with PortAudio
+ */
+class PortAudioBackend : public AudioBackend {
+private:
+	PaStream* stream      = nullptr;
+	bool      initialized = false;
+	PaError   last_error  = paNoError;
+
+public:
+	PortAudioBackend() = default;
+
+	PortAudioBackend(const PortAudioBackend& rhs) = delete;
+	PortAudioBackend& operator=(const PortAudioBackend& rhs) = delete;
+
+	~PortAudioBackend() override;
+
+	bool open(const AudioStreamConfig& config, PaStreamCallback* callback,
+	          PaStreamFinishedCallback* finished_callback, void* user_data) override;
+	bool start() override;
+	void stop() override;
+	void close() override;
+	bool is_active() const override;
+	PaError get_last_error() const override;
+
+private:
+	bool check(const PaError err);
+};
+
+/**
+ * @brief Calls back from its own thread without a device. In real time, each
+ * callback is made at the time a sound card would ask for it, and a callback that
+ * starts late is flagged with paOutputUnderflow. Otherwise, callbacks are made as
+ * fast as possible, e.g. to benchmark the cost of a callback.
+ */
+class NullBackend : public AudioBackend {
+private:
+	AudioStreamConfig          config;
+	PaStreamCallback*          callback          = nullptr;
+	PaStreamFinishedCallback*  finished_callback = nullptr;
+	void*                      user_data         = nullptr;
+	bool                       real_time;
+	bool                       opened            = false;
+	std::vector<float>         buffer;
+	std::thread                thread;
+	std::atomic<bool>          running           = false;
+	std::atomic<bool>          active            = false;
+	std::atomic<uint64_t>      num_buffers       = 0;
+	std::atomic<uint64_t>      num_underflows    = 0;
+
+public:
+	/**
+	 * @param real_time Whether to pace the callbacks like a sound card would
+	 */
+	explicit NullBackend(const bool real_time = true);
+
+	NullBackend(const NullBackend& rhs) = delete;
+	NullBackend& operator=(const NullBackend& rhs) = delete;
+
+	~NullBackend() override;
+
+	bool open(const AudioStreamConfig& config, PaStreamCallback* callback,
+	          PaStreamFinishedCallback* finished_callback, void* user_data) override;
+	bool start() override;
+	void stop() override;
+	void close() override;
+	bool is_active() const override;
+	PaError get_last_error() const override;
+
+	bool is_real_time() const;
+	/**
+	 * @return Number of buffers that have been rendered
+	 */
+	uint64_t buffer_count() const;
+	/**
+	 * @return Number of real-time callbacks that started after their deadline
+	 */
+	uint64_t underflow_count() const;
+
+protected:
+	/**
+	 * @brief  Called from the callback thread with every buffer that would have been played
+	 * @return Whether the buffer was delivered. The stream is stopped if it was not
+	 */
+	virtual bool deliver(const float* const samples, const size_t num_frames);
+
+private:
+	void run();
+};
+
+/**
+ * @brief NullBackend that writes everything that would have been played to a sound
+ * file, e.g. to check the output of the audio callback on a render server. A failed
+ * write, e.g. on a full disk, stops the stream, and get_last_error then returns
+ * paInternalError so the render can be reported as failed.
+ */
+class FileSinkBackend : public NullBackend {
+private:
+	std::string       file_path;
+	int32_t           format;
+	SNDFILE*          sf = nullptr;
+	/// Set by the callback thread when a buffer could not be written in full
+	std::atomic<bool> write_failed = false;
+
+public:
+	/**
+	 * @param file_path Path of the sound file to write
+	 * @param real_time Whether to pace the callbacks like a sound card would
+	 * @param format libsndfile format of the file (major format | subtype)
+	 */
+	explicit FileSinkBackend(const std::string& file_path, const bool real_time = false,
+	                         const int32_t format = SF_FORMAT_WAV | SF_FORMAT_FLOAT);
+
+	~FileSinkBackend() override;
+
+	bool open(const AudioStreamConfig& config, PaStreamCallback* callback,
+	          PaStreamFinishedCallback* finished_callback, void* user_data) override;
+	void close() override;
+	/**
+	 * @return paInternalError if the file could not be written in full, otherwise paNoError
+	 */
+	PaError get_last_error() const override;
+
+protected:
+	bool deliver(const float* const samples, const size_t num_frames) override;
+};
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include <portaudio.h>
+#include <lfmq/message.hpp>
+#include <lfmq/lock_free_queue.hpp>
+
+#include "dsp_declarations.hpp"
+#include "signals.hpp"
+#include "streaming_source.hpp"
+#include "audio_thread_data.hpp"
+#include "audio_backend.hpp"
+#include "effect_chain.hpp"
+#include "telemetry.hpp"
+
+/**
+ * @brief Configuration of the output stream of an AudioEngine
+ */
+struct AudioEngineConfig {
+	/// Sample rate of the stream. 0 uses the sample rate of the source, which is not resampled
+	dsp::sample_rate_t sample_rate       = 0;
+	/// Frames per callback. 0 lets the host choose, which usually gives the lowest latency
+	size_t             frames_per_buffer = dsp::FRAMES_PER_BUFFER;
+	/// Number of output channels of the device
+	size_t             num_channels      = dsp::NUM_CHANNELS;
+	/// Output device. paNoDevice uses the default output device
+	PaDeviceIndex      device            = paNoDevice;
+	/// Suggested output latency in seconds. 0 uses the device's default low latency
+	PaTime             suggested_latency = 0.0;
+	/// Maximum number of commands taken from the queue per callback. 0 drains the queue
+	size_t             max_messages_per_callback = 0;
+	/// Time after which no more commands are taken from the queue in a callback. 0 is unlimited
+	std::chrono::microseconds message_time_budget = std::chrono::microseconds(0);
+	/// Whether a CallbackRecord is posted to the telemetry channel after every callback
+	bool               collect_telemetry = true;
+};
+
+/**
+ * @brief Plays a signal, a streaming source, or a view of samples in place through
+ * an AudioBackend, which is a
+ * PortAudio output stream unless another backend is given, e.g. a NullBackend on a
+ * machine without sound hardware. The engine owns the backend, the AudioThreadData
+ * of the audio thread, the queue of commands sent to it, and the effect chain
+ * applied to the output.
+ *
+ * Audio is processed in dsp::NUM_CHANNELS channels and mapped to the channel count
+ * of the device when it is copied into the output buffer. open, start, stop, wait,
+ * and close must be called from the control thread. send may be called from a
+ * single producer thread while the stream is running.
+ *
+ * Every callback drains the pending commands in one batch, within the count and
+ * time budgets of the config, so a burst of commands is applied within one buffer.
+ * Runs of the same command are coalesced: only the last PLAY_AT is performed, and
+ * PAUSE and VOLUME toggles that cancel each other out are dropped.
+ */
+class AudioEngine {
+public:
+	using Config = AudioEngineConfig;
+
+	/// Number of commands that may be waiting for the audio thread
+	static constexpr size_t QUEUE_CAPACITY = 256;
+
+private:
+	Config                                          config;
+	std::unique_ptr<AudioBackend>                   backend;
+	bool                                            opened      = false;
+	AudioThreadData                                 atd;
+	EffectChainHost<dsp::sample_t>                  effects;
+	lfmq::SpscQueue<lfmq::Message, QUEUE_CAPACITY>  message_queue;
+	CallbackTelemetry                               telemetry;
+	/// Set by the backend's finished callback once the stream has become inactive
+	std::mutex                                      finished_mutex;
+	std::condition_variable                         finished_cv;
+	bool                                            finished    = true;
+
+public:
+	/**
+	 * @brief Engine that plays through PortAudio
+	 */
+	AudioEngine();
+	explicit AudioEngine(std::unique_ptr<AudioBackend> backend);
+
+	AudioEngine(const AudioEngine& rhs) = delete;
+	AudioEngine& operator=(const AudioEngine& rhs) = delete;
+
+	~AudioEngine();
+
+	/**
+	 * @brief  Open an output stream that plays a decoded signal, looping at its end.
+	 * Playback is paused until a PLAY_AT command is sent
+	 * @param  signal Signal to play. Must outlive the stream
+	 * @param  config Configuration of the stream
+	 * @return Whether the stream was able to be opened
+	 */
+	bool open(const dsp::PlanarSignal<dsp::sample_t>* signal, const Config& config = Config());
+	/**
+	 * @brief  Open an output stream that plays a file streamed from disk.
+	 * Playback is paused until a PLAY_AT command is sent
+	 * @param  source Open streaming source. Must outlive the stream
+	 * @param  config Configuration of the stream
+	 * @return Whether the stream was able to be opened
+	 */
+	bool open(StreamingSource* source, const Config& config = Config());
+	/**
+	 * @brief  Open an output stream that plays interleaved samples in place, looping at
+	 * their end, e.g. the view of a memory mapped AudioFile, without decoding or copying
+	 * them first. Playback is paused until a PLAY_AT command is sent
+	 * @param  view Samples to play. The samples must outlive the stream
+	 * @param  config Configuration of the stream
+	 * @return Whether the stream was able to be opened
+	 */
+	bool open(const dsp::SignalView<dsp::sample_t>& view, const Config& config = Config());
+
+	/**
+	 * @brief  Start calling back into the engine for audio
+	 * @return Whether the stream was able to be started
+	 */
+	bool start();
+	/**
+	 * @brief Stop the stream once the buffers that were already queued have played
+	 */
+	void stop();
+	/**
+	 * @brief Close the stream, discarding any buffers that have not been played
+	 */
+	void close();
+
+	/**
+	 * @brief Block until the stream becomes inactive, e.g. after a STOP command.
+	 * Returns immediately if the stream is not running
+	 */
+	void wait();
+	/**
+	 * @return Whether the stream became inactive before the timeout
+	 */
+	bool wait_for(const std::chrono::milliseconds timeout);
+
+	/**
+	 * @brief  Queue a command for the audio thread. Real-time safe
+	 * @return Whether there was room in the queue for the command
+	 */
+	bool send(const lfmq::Message& msg);
+
+	bool is_open() const;
+	bool is_active() const;
+	/**
+	 * @return Sample rate the stream was opened with
+	 */
+	dsp::sample_rate_t sample_rate() const;
+	const Config& get_config() const;
+	/**
+	 * @return Last error of the backend, e.g. to pass to Pa_GetErrorText. A FileSinkBackend
+	 * returns paInternalError once a write has failed, which also stops the stream
+	 */
+	PaError get_last_error() const;
+	AudioBackend& get_backend();
+
+	/**
+	 * @brief Effects applied to the output. Modify them by copying latest(), editing
+	 * the copy, and submitting it
+	 */
+	EffectChainHost<dsp::sample_t>& get_effects();
+
+	/**
+	 * @brief Timing, xruns, and position of every callback. Drain it from the control
+	 * thread, e.g. with CallbackStats::collect
+	 */
+	CallbackTelemetry& get_telemetry();
+
+private:
+	bool open_stream(const dsp::sample_rate_t source_sample_rate, const Config& config);
+
+	static int32_t stream_callback(const void* input_buffer, void* output_buffer,
+		unsigned long frames_per_buffer, const PaStreamCallbackTimeInfo* time_info,
+		PaStreamCallbackFlags status_flags, void* user_data);
+	static void stream_finished_callback(void* user_data);
+
+	int32_t process(float* const out_buf, const size_t frames_per_buffer);
+
+	/**
+	 * @return Number of messages taken from the queue
+	 */
+	size_t process_messages();
+	/**
+	 * @brief Perform the last of a run of num_repeats messages of the same type
+	 */
+	bool process_coalesced(const lfmq::Message& msg, const size_t num_repeats);
+	bool process_message(const lfmq::Message& msg);
+	bool process_play_message(const dsp::time_ms_t time);
+	bool process_pause_message();
+	bool process_volume_message();
+	bool process_stop_message();
+};
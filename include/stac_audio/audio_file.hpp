@@ -1,33 +1,79 @@
-#pragma once
-
-#include <string>
-
-#include "signals.hpp"
-
-class AudioFileMetadata {
-private:
-	// format
-	// num_channels
-	// sample_rate
-	// 
-public:
-};
-
-class AudioFile {
-private:
-	AudioFileMetadata          metadata;
-	dsp::Signal<dsp::sample_t> signal;
-	std::string                file_path;
-
-public:
-	AudioFile() = default;
-	AudioFile(const std::string& file_path);
-
-	/**
-	 * Should probably switch case off of the format
-	 * to then read with the correct sf_read function
-	 */
-	void load(const std::string& file_path);
-	void save();
-
-};
\ No newline at end of file
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+#include "signals.hpp"
+#include "mapped_audio_file.hpp"
+
+class AudioFileMetadata {
+public:
+	/// libsndfile format of the file (major format | subtype)
+	int32_t            format       = 0;
+	uint32_t           num_channels = 0;
+	dsp::sample_rate_t sample_rate  = 0;
+	/// Number of frames, as reported by the header of the file
+	size_t             num_frames   = 0;
+};
+
+/**
+ * @brief Sound file loaded into memory, either decoded into a planar signal or mapped
+ * and viewed in place. Movable but not copyable, since a memory mapped file owns
+ * its mapping. Moving keeps views of the samples valid.
+ */
+class AudioFile {
+public:
+	/// Number of frames decoded per read from the sound file
+	static constexpr size_t READ_BLOCK_FRAMES = 65536;
+
+	enum class LoadMode {
+		/// Decode the file into the planar signal
+		DECODE,
+		/// Map the file into memory and view its samples in place when it is a 32-bit float WAV
+		/// file, otherwise decode it
+		MEMORY_MAPPED
+	};
+
+private:
+	AudioFileMetadata                metadata;
+	dsp::PlanarSignal<dsp::sample_t> signal;
+	MappedAudioFile                  mapped_file;
+	std::string                      file_path;
+
+public:
+	AudioFile() = default;
+	AudioFile(const std::string& file_path);
+
+	AudioFile(const AudioFile& rhs) = delete;
+	AudioFile& operator=(const AudioFile& rhs) = delete;
+
+	AudioFile(AudioFile&& rhs) noexcept = default;
+	AudioFile& operator=(AudioFile&& rhs) noexcept = default;
+
+	/**
+	 * @brief  Load and decode a sound file of any channel count into the signal.
+	 * The signal is sized once from the file header and filled in large blocks. Files
+	 * of unknown length, e.g. pipes, are rejected. A failed load leaves the file empty.
+	 * @param  file_path Path of the sound file to load
+	 * @param  mode Whether to attempt to memory map the file rather than decode it
+	 * @return Whether the file was able to be opened and read
+	 */
+	bool load(const std::string& file_path, const LoadMode mode = LoadMode::DECODE);
+	void save();
+
+	const AudioFileMetadata& get_metadata() const;
+	/**
+	 * @return Decoded signal. Empty if the file is memory mapped
+	 */
+	const dsp::PlanarSignal<dsp::sample_t>& get_signal() const;
+	/**
+	 * @return Whether the file was memory mapped rather than decoded
+	 */
+	bool is_memory_mapped() const;
+	/**
+	 * @return Zero-copy view of the samples of a memory mapped file, which AudioEngine::open
+	 * and OfflineRenderer::render play in place. Empty if the file was decoded
+	 */
+	const dsp::SignalView<dsp::sample_t>& get_view() const;
+	const std::string& get_file_path() const;
+};
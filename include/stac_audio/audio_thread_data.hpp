@@ -1,36 +1,37 @@
-#pragma once
-
-#include <complex>
-#include <tuple>
-#include <fftw3.h>
-#include "dsp_declarations.hpp"
-#include "signals.hpp"
-
-enum class AudioThreadState {
-	PLAYING,
-	PAUSED,
-	IDLE,
-	STARTING
-};
-
-struct AudioThreadData {
-	AudioThreadState                                   state            = AudioThreadState::IDLE;
-	const dsp::Signal<dsp::sample_t>*                  signal           = nullptr;
-	dsp::Wave<dsp::sample_t, dsp::FRAMES_PER_BUFFER>   wave;
-	size_t                                             sample_index     = 0;
-	/// Volume of the wave
-	dsp::amplitude_t                                   amplitude_scalar = 1.0;
-	dsp::pitch_t                                       pitch_shift      = 0.0;
-	/// Size of the complex wave is the size of the real wave / 2 + 1
-	static constexpr size_t COMPLEX_WAVE_SIZE = std::tuple_size_v<decltype(wave)> / 2 + 1;
-	dsp::Wave<std::complex<dsp::sample_t>, COMPLEX_WAVE_SIZE> complex_wave;
-	/// TODO implement the dft functionality
-	fftw_plan                                          r2c_plan         = nullptr;
-	fftw_plan                                          c2r_plan         = nullptr;
-};
-
-/*
- * TODO need to have some sort of structure that contains the fftw_plan,
- * buffers, and functionality to create and destroy these things that are
- * real-time audio thread safe
- */
+#pragma once
+
+#include <complex>
+#include <tuple>
+#include "dsp_declarations.hpp"
+#include "signals.hpp"
+#include "streaming_source.hpp"
+#include "smoothed_value.hpp"
+#include "effect_chain.hpp"
+
+enum class AudioThreadState {
+	PLAYING,
+	PAUSED,
+	IDLE,
+	STARTING
+};
+
+struct AudioThreadData {
+	AudioThreadState                                   state            = AudioThreadState::IDLE;
+	/// Signal being played. May have any number of channels, and is mixed to the wave's channels
+	const dsp::PlanarSignal<dsp::sample_t>*            signal           = nullptr;
+	/// Streamed from disk in place of the signal when not null
+	StreamingSource*                                   stream           = nullptr;
+	/// Interleaved samples played in place, e.g. of a memory mapped file, when neither the
+	/// signal nor the stream is set
+	dsp::SignalView<dsp::sample_t>                     view;
+	dsp::Wave<dsp::sample_t, dsp::FRAMES_PER_BUFFER>   wave;
+	size_t                                             sample_index     = 0;
+	/// Volume of the wave, ramped to new values to avoid clicks
+	dsp::SmoothedValue<dsp::amplitude_t>               amplitude_scalar = dsp::SmoothedValue<dsp::amplitude_t>(1.0);
+	dsp::pitch_t                                       pitch_shift      = 0.0;
+	/// Effects applied to the wave. Owned by the control thread
+	EffectChainHost<dsp::sample_t>*                    effects          = nullptr;
+	/// Size of the complex wave is the size of the real wave / 2 + 1
+	static constexpr size_t COMPLEX_WAVE_SIZE = std::tuple_size_v<decltype(wave)> / 2 + 1;
+	dsp::Wave<std::complex<dsp::sample_t>, COMPLEX_WAVE_SIZE> complex_wave;
+};
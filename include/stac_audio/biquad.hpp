@@ -1,26 +1,186 @@
 #pragma once
 
 #include <stdint.h>
+#include <array>
+#include <span>
+#include <cmath>
+#include <numbers>
+#include <algorithm>
+#include <type_traits>
+#include <cassert>
 
 #include "dsp_declarations.hpp"
+#include "signals.hpp"
+#include "simd.hpp"
 
 namespace dsp {
+enum class BiquadType {
+	UNKNOWN    = 0,
+	LOW_PASS   = 1,
+	HIGH_PASS  = 2,
+	BAND_PASS  = 3,
+	NOTCH      = 4,
+	PEAK       = 5,
+	LOW_SHELF  = 6,
+	HIGH_SHELF = 7
+};
+
+/**
+ * @brief Coefficients of a biquad, normalized so that the a0 of the denominator is 1.
+ * a0, a1, a2 are the feedforward (numerator) coefficients and b1, b2 are the feedback
+ * (denominator) coefficients. The default coefficients pass the input through unchanged.
+ */
 template<typename _sample_t>
+struct BiquadCoefficients {
+	_sample_t a0 = _sample_t(1);
+	_sample_t a1 = _sample_t(0);
+	_sample_t a2 = _sample_t(0);
+	_sample_t b1 = _sample_t(0);
+	_sample_t b2 = _sample_t(0);
+
+	/**
+	 * @brief  Compute the coefficients of a filter from the Audio EQ Cookbook (Robert Bristow-Johnson)
+	 * @param  type Type of the filter. UNKNOWN passes the input through
+	 * @param  sample_rate Sample rate of the filtered signal
+	 * @param  f0 Center or corner frequency
+	 * @param  q Quality factor
+	 * @param  peak_gain Gain of the PEAK, LOW_SHELF and HIGH_SHELF filters, in dB
+	 */
+	static BiquadCoefficients compute(const BiquadType type, const sample_rate_t sample_rate, const double f0,
+	                                  const bandwidth_t q, const gain_db_t peak_gain) {
+		if (type == BiquadType::UNKNOWN || sample_rate == 0 || q <= 0.0) {
+			return BiquadCoefficients();
+		}
+
+		const double w0 = 2.0 * std::numbers::pi * f0 / static_cast<double>(sample_rate);
+		const double cos_w0 = std::cos(w0);
+		const double alpha = std::sin(w0) / (2.0 * q);
+		const double A = std::pow(10.0, peak_gain / 40.0);
+		const double sqrt_A_alpha = 2.0 * std::sqrt(A) * alpha;
+		double n0 = 1.0, n1 = 0.0, n2 = 0.0;
+		double d0 = 1.0, d1 = 0.0, d2 = 0.0;
+
+		switch (type) {
+			case BiquadType::LOW_PASS:
+				n0 = (1.0 - cos_w0) / 2.0;
+				n1 = 1.0 - cos_w0;
+				n2 = (1.0 - cos_w0) / 2.0;
+				d0 = 1.0 + alpha;
+				d1 = -2.0 * cos_w0;
+				d2 = 1.0 - alpha;
+				break;
+			case BiquadType::HIGH_PASS:
+				n0 = (1.0 + cos_w0) / 2.0;
+				n1 = -(1.0 + cos_w0);
+				n2 = (1.0 + cos_w0) / 2.0;
+				d0 = 1.0 + alpha;
+				d1 = -2.0 * cos_w0;
+				d2 = 1.0 - alpha;
+				break;
+			case BiquadType::BAND_PASS:
+				// constant 0 dB peak gain
+				n0 = alpha;
+				n1 = 0.0;
+				n2 = -alpha;
+				d0 = 1.0 + alpha;
+				d1 = -2.0 * cos_w0;
+				d2 = 1.0 - alpha;
+				break;
+			case BiquadType::NOTCH:
+				n0 = 1.0;
+				n1 = -2.0 * cos_w0;
+				n2 = 1.0;
+				d0 = 1.0 + alpha;
+				d1 = -2.0 * cos_w0;
+				d2 = 1.0 - alpha;
+				break;
+			case BiquadType::PEAK:
+				n0 = 1.0 + alpha * A;
+				n1 = -2.0 * cos_w0;
+				n2 = 1.0 - alpha * A;
+				d0 = 1.0 + alpha / A;
+				d1 = -2.0 * cos_w0;
+				d2 = 1.0 - alpha / A;
+				break;
+			case BiquadType::LOW_SHELF:
+				n0 = A * ((A + 1.0) - (A - 1.0) * cos_w0 + sqrt_A_alpha);
+				n1 = 2.0 * A * ((A - 1.0) - (A + 1.0) * cos_w0);
+				n2 = A * ((A + 1.0) - (A - 1.0) * cos_w0 - sqrt_A_alpha);
+				d0 = (A + 1.0) + (A - 1.0) * cos_w0 + sqrt_A_alpha;
+				d1 = -2.0 * ((A - 1.0) + (A + 1.0) * cos_w0);
+				d2 = (A + 1.0) + (A - 1.0) * cos_w0 - sqrt_A_alpha;
+				break;
+			case BiquadType::HIGH_SHELF:
+				n0 = A * ((A + 1.0) + (A - 1.0) * cos_w0 + sqrt_A_alpha);
+				n1 = -2.0 * A * ((A - 1.0) + (A + 1.0) * cos_w0);
+				n2 = A * ((A + 1.0) + (A - 1.0) * cos_w0 - sqrt_A_alpha);
+				d0 = (A + 1.0) - (A - 1.0) * cos_w0 + sqrt_A_alpha;
+				d1 = 2.0 * ((A - 1.0) - (A + 1.0) * cos_w0);
+				d2 = (A + 1.0) - (A - 1.0) * cos_w0 - sqrt_A_alpha;
+				break;
+			case BiquadType::UNKNOWN:
+				break;
+		}
+
+		BiquadCoefficients coefficients;
+
+		coefficients.a0 = static_cast<_sample_t>(n0 / d0);
+		coefficients.a1 = static_cast<_sample_t>(n1 / d0);
+		coefficients.a2 = static_cast<_sample_t>(n2 / d0);
+		coefficients.b1 = static_cast<_sample_t>(d1 / d0);
+		coefficients.b2 = static_cast<_sample_t>(d2 / d0);
+
+		return coefficients;
+	}
+
+	/**
+	 * @return Coefficients the fraction t of the way from these coefficients to the target
+	 */
+	BiquadCoefficients lerp(const BiquadCoefficients& target, const _sample_t t) const {
+		BiquadCoefficients coefficients;
+
+		coefficients.a0 = this->a0 + (target.a0 - this->a0) * t;
+		coefficients.a1 = this->a1 + (target.a1 - this->a1) * t;
+		coefficients.a2 = this->a2 + (target.a2 - this->a2) * t;
+		coefficients.b1 = this->b1 + (target.b1 - this->b1) * t;
+		coefficients.b2 = this->b2 + (target.b2 - this->b2) * t;
+
+		return coefficients;
+	}
+};
+
+/**
+ * @brief Biquad filter in transposed direct form II with independent state for
+ * each of _num_channels channels. Whole buffers are filtered at once, either one
+ * planar channel at a time or every channel of interleaved frames at once. When
+ * SSE2 is available, the channels of float frames are filtered in parallel lanes.
+ *
+ * commit, set_params and set_coefficients change the coefficients in place and
+ * must not be called while another thread is filtering. To change a filter that
+ * is running on the audio thread, use a BiquadEffect, which publishes coefficients
+ * computed on the control thread through a dsp::TripleBuffer and ramps to them
+ * on the audio thread.
+ */
+template<typename _sample_t, size_t _num_channels = NUM_CHANNELS>
 class Biquad {
+public:
+	using Type = BiquadType;
+	using frame_type = Frame<_sample_t, _num_channels>;
+
+	static constexpr size_t num_channels = _num_channels;
+
 private:
-	_sample_t a0, a1, a2, b1, b2;
-	_sample_t z1, z2;
+	BiquadCoefficients<_sample_t>        coefficients;
+	std::array<_sample_t, _num_channels> z1 = { };
+	std::array<_sample_t, _num_channels> z2 = { };
+	/// Coefficients that the ramp ends at
+	BiquadCoefficients<_sample_t>        target_coefficients;
+	/// Number of frames until the target coefficients are reached
+	size_t                               ramp_remaining = 0;
+
 public:
-	enum class Type {
-		UNKNOWN    = 0,
-		LOW_PASS   = 1,
-		HIGH_PASS  = 2,
-		BAND_PASS  = 3,
-		NOTCH      = 4,
-		PEAK       = 5,
-		LOW_SHELF  = 6,
-		HIGH_SHELF = 7
-	};
+	/// Number of frames filtered with each step of a coefficient ramp
+	static constexpr size_t RAMP_STEP_FRAMES = 16;
 
 	Type          type        = Type::UNKNOWN;
 	sample_rate_t sample_rate = SAMPLE_RATE;
@@ -42,23 +202,232 @@ public:
 	}
 
 	/**
-	 * @brief Commit changes to the parameters that occurred after initilization
+	 * @brief Recompute the coefficients from the public parameters after they have been modified
+	 */
+	void commit() {
+		this->coefficients = BiquadCoefficients<_sample_t>::compute(this->type, this->sample_rate, this->f0, this->q,
+		                                                            this->peak_gain);
+		this->ramp_remaining = 0;
+	}
+
+	/**
+	 * @brief Set every parameter and recompute the coefficients. The filter state is kept
+	 * so that the output stays continuous
 	 */
 	void set_params(const Type type, const sample_rate_t sample_rate, const _sample_t f0, const bandwidth_t q, const gain_db_t peak_gain) {
 		this->type = type;
 		this->sample_rate = sample_rate;
+		this->f0 = f0;
+		this->q = q;
 		this->peak_gain = peak_gain;
 
 		this->commit();
 	}
 
+	const BiquadCoefficients<_sample_t>& get_coefficients() const {
+		return this->coefficients;
+	}
+
+	/**
+	 * @brief Use precomputed coefficients, e.g. ones computed off the audio thread,
+	 * without modifying the public parameters
+	 */
+	void set_coefficients(const BiquadCoefficients<_sample_t>& coefficients) {
+		this->coefficients = coefficients;
+		this->ramp_remaining = 0;
+	}
+
+	/**
+	 * @brief Move the coefficients linearly to the target over the next num_frames
+	 * frames filtered through process(std::span<frame_type>), in steps of
+	 * RAMP_STEP_FRAMES, so that the change is not heard as a click or zipper noise
+	 * @param target Coefficients to end at
+	 * @param num_frames Length of the ramp. 0 changes the coefficients immediately
+	 */
+	void ramp_to(const BiquadCoefficients<_sample_t>& target, const size_t num_frames) {
+		this->target_coefficients = target;
+		this->ramp_remaining = num_frames;
+
+		if (num_frames == 0) {
+			this->coefficients = target;
+		}
+	}
+
+	bool is_ramping() const {
+		return this->ramp_remaining > 0;
+	}
+
+	/**
+	 * @brief Clear the state of every channel
+	 */
+	void reset() {
+		this->z1.fill(_sample_t(0));
+		this->z2.fill(_sample_t(0));
+	}
+
 	/**
 	 * @brief Apply biquad filter to a sample
 	 * @param sample Sample to apply the biquad filter to
+	 * @param channel Channel whose state is used
 	 */
 	template<typename __sample_t>
-	void apply(__sample_t& sample) const {
-		
+	void apply(__sample_t& sample, const size_t channel = 0) {
+		const BiquadCoefficients<_sample_t>& c = this->coefficients;
+		const _sample_t in = static_cast<_sample_t>(sample);
+		const _sample_t out = in * c.a0 + this->z1[channel];
+
+		this->z1[channel] = in * c.a1 + this->z2[channel] - c.b1 * out;
+		this->z2[channel] = in * c.a2 - c.b2 * out;
+		sample = static_cast<__sample_t>(out);
+	}
+
+	/**
+	 * @brief Filter every channel of one frame in place, e.g. as a stage of a dsp::Pipeline.
+	 * Does not advance the coefficient ramp
+	 */
+	void process_frame(frame_type& frame) {
+		const BiquadCoefficients<_sample_t>& c = this->coefficients;
+
+		for (size_t ch = 0; ch < _num_channels; ch++) {
+			const _sample_t in = frame[ch];
+			const _sample_t out = in * c.a0 + this->z1[ch];
+
+			this->z1[ch] = in * c.a1 + this->z2[ch] - c.b1 * out;
+			this->z2[ch] = in * c.a2 - c.b2 * out;
+			frame[ch] = out;
+		}
+	}
+
+	/**
+	 * @brief Filter the samples of one channel in place, e.g. a dsp::PlanarSignal channel
+	 * @param samples Samples to filter
+	 * @param channel Channel whose state is used
+	 */
+	void process(const std::span<_sample_t> samples, const size_t channel = 0) {
+		assert(channel < _num_channels);
+
+		const BiquadCoefficients<_sample_t> c = this->coefficients;
+		_sample_t z1 = this->z1[channel];
+		_sample_t z2 = this->z2[channel];
+
+		for (_sample_t& sample : samples) {
+			const _sample_t in = sample;
+			const _sample_t out = in * c.a0 + z1;
+
+			z1 = in * c.a1 + z2 - c.b1 * out;
+			z2 = in * c.a2 - c.b2 * out;
+			sample = out;
+		}
+
+		this->z1[channel] = z1;
+		this->z2[channel] = z2;
+	}
+
+	/**
+	 * @brief Filter every channel of interleaved frames in place, advancing the coefficient ramp if there is one
+	 */
+	void process(const std::span<frame_type> frames) {
+		static_assert(sizeof(frame_type) == sizeof(_sample_t) * _num_channels,
+		              "Frame must be laid out as _num_channels contiguous samples");
+
+		_sample_t* const samples = reinterpret_cast<_sample_t*>(frames.data());
+		size_t frame_index = 0;
+
+		while (this->ramp_remaining > 0 && frame_index < frames.size()) {
+			const size_t len = std::min({ RAMP_STEP_FRAMES, this->ramp_remaining, frames.size() - frame_index });
+
+			this->coefficients = this->coefficients.lerp(this->target_coefficients,
+			                                             static_cast<_sample_t>(len) / static_cast<_sample_t>(this->ramp_remaining));
+			this->ramp_remaining -= len;
+
+			if (this->ramp_remaining == 0) {
+				this->coefficients = this->target_coefficients;
+			}
+
+			this->process_frames(samples + frame_index * _num_channels, len);
+			frame_index += len;
+		}
+
+		this->process_frames(samples + frame_index * _num_channels, frames.size() - frame_index);
+	}
+
+	template<size_t _capacity>
+	void process(Wave<_sample_t, _capacity, _num_channels>& wave) {
+		this->process(std::span<frame_type>(wave));
+	}
+
+private:
+	void process_frames(_sample_t* const samples, const size_t num_frames) {
+#if defined(STAC_AUDIO_SSE2)
+		if constexpr (std::is_same_v<_sample_t, float> && (_num_channels == 2 || _num_channels == 4)) {
+			this->process_sse(samples, num_frames);
+			return;
+		}
+#endif
+
+		const BiquadCoefficients<_sample_t> c = this->coefficients;
+
+		for (size_t i = 0; i < num_frames; i++) {
+			for (size_t ch = 0; ch < _num_channels; ch++) {
+				_sample_t& sample = samples[i * _num_channels + ch];
+				const _sample_t in = sample;
+				const _sample_t out = in * c.a0 + this->z1[ch];
+
+				this->z1[ch] = in * c.a1 + this->z2[ch] - c.b1 * out;
+				this->z2[ch] = in * c.a2 - c.b2 * out;
+				sample = out;
+			}
+		}
+	}
+
+#if defined(STAC_AUDIO_SSE2)
+	/**
+	 * @brief Filter interleaved float frames with one channel per lane. Frames of two
+	 * channels use the lower two lanes
+	 */
+	void process_sse(float* const samples, const size_t num_frames) {
+		const BiquadCoefficients<float>& c = this->coefficients;
+		const __m128 a0 = _mm_set1_ps(c.a0);
+		const __m128 a1 = _mm_set1_ps(c.a1);
+		const __m128 a2 = _mm_set1_ps(c.a2);
+		const __m128 b1 = _mm_set1_ps(c.b1);
+		const __m128 b2 = _mm_set1_ps(c.b2);
+		alignas(16) float z1_lanes[4] = { };
+		alignas(16) float z2_lanes[4] = { };
+
+		std::copy(this->z1.begin(), this->z1.end(), z1_lanes);
+		std::copy(this->z2.begin(), this->z2.end(), z2_lanes);
+
+		__m128 z1 = _mm_load_ps(z1_lanes);
+		__m128 z2 = _mm_load_ps(z2_lanes);
+
+		for (size_t i = 0; i < num_frames; i++) {
+			float* const frame = samples + i * _num_channels;
+			__m128 in;
+
+			if constexpr (_num_channels == 2) {
+				in = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(frame));
+			} else {
+				in = _mm_loadu_ps(frame);
+			}
+
+			const __m128 out = _mm_add_ps(_mm_mul_ps(in, a0), z1);
+
+			z1 = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(in, a1), z2), _mm_mul_ps(b1, out));
+			z2 = _mm_sub_ps(_mm_mul_ps(in, a2), _mm_mul_ps(b2, out));
+
+			if constexpr (_num_channels == 2) {
+				_mm_storel_pi(reinterpret_cast<__m64*>(frame), out);
+			} else {
+				_mm_storeu_ps(frame, out);
+			}
+		}
+
+		_mm_store_ps(z1_lanes, z1);
+		_mm_store_ps(z2_lanes, z2);
+		std::copy_n(z1_lanes, _num_channels, this->z1.begin());
+		std::copy_n(z2_lanes, _num_channels, this->z2.begin());
 	}
+#endif
 };
 }
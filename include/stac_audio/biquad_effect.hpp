@@ -0,0 +1,93 @@
+#pragma once
+
+#include <span>
+#include <cstddef>
+
+#include "dsp_declarations.hpp"
+#include "effect.hpp"
+#include "biquad.hpp"
+#include "triple_buffer.hpp"
+
+/**
+ * @brief Biquad effect that may be retuned by the control thread while the audio
+ * thread is filtering with it.
+ *
+ * set_params computes the new coefficients on the control thread and publishes
+ * them through a dsp::TripleBuffer. At the start of its next block, the audio
+ * thread takes the latest coefficients and ramps the filter to them, so retuning
+ * neither races with the filter nor clicks. Only the latest of several quick
+ * changes is heard.
+ */
+template<typename _sample_t = dsp::sample_t, size_t _num_channels = dsp::NUM_CHANNELS>
+class BiquadEffect : public Effect<_sample_t, _num_channels> {
+public:
+	using biquad_type       = dsp::Biquad<_sample_t, _num_channels>;
+	using coefficients_type = dsp::BiquadCoefficients<_sample_t>;
+	using frame_type        = typename Effect<_sample_t, _num_channels>::frame_type;
+
+	/// Default number of frames over which the filter moves to new coefficients
+	static constexpr size_t DEFAULT_RAMP_FRAMES = 512;
+
+	struct Params {
+		dsp::BiquadType    type        = dsp::BiquadType::UNKNOWN;
+		dsp::sample_rate_t sample_rate = dsp::SAMPLE_RATE;
+		_sample_t          f0          = _sample_t();
+		dsp::bandwidth_t   q           = dsp::bandwidth_t();
+		dsp::gain_db_t     peak_gain   = dsp::gain_db_t();
+	};
+
+private:
+	/// Audio thread only once the effect is running
+	biquad_type                          biquad;
+	dsp::TripleBuffer<coefficients_type> pending_coefficients;
+	/// Control thread only. Parameters of the latest coefficients published
+	Params                               params;
+	size_t                               ramp_frames;
+
+public:
+	BiquadEffect(const dsp::BiquadType type, const dsp::sample_rate_t sample_rate, const _sample_t f0,
+	             const dsp::bandwidth_t q, const dsp::gain_db_t peak_gain,
+	             const size_t ramp_frames = DEFAULT_RAMP_FRAMES) :
+		biquad(type, sample_rate, f0, q, peak_gain),
+		pending_coefficients(this->biquad.get_coefficients()),
+		params{ type, sample_rate, f0, q, peak_gain },
+		ramp_frames(ramp_frames)
+	{ }
+
+	/**
+	 * @brief Control thread only. Retune the filter. Real-time safe, so it may be called
+	 * as often as a slider moves
+	 */
+	void set_params(const dsp::BiquadType type, const dsp::sample_rate_t sample_rate, const _sample_t f0,
+	                const dsp::bandwidth_t q, const dsp::gain_db_t peak_gain) {
+		this->params = Params{ type, sample_rate, f0, q, peak_gain };
+		this->pending_coefficients.write(coefficients_type::compute(type, sample_rate, f0, q, peak_gain));
+	}
+
+	/**
+	 * @brief Control thread only. Retune the filter to precomputed coefficients. The
+	 * parameters returned by get_params are left as they were
+	 */
+	void set_coefficients(const coefficients_type& coefficients) {
+		this->pending_coefficients.write(coefficients);
+	}
+
+	/**
+	 * @brief Control thread only. Parameters last passed to the constructor or set_params
+	 */
+	const Params& get_params() const {
+		return this->params;
+	}
+
+	void process(const std::span<frame_type> frames) override {
+		if (this->pending_coefficients.update()) {
+			this->biquad.ramp_to(this->pending_coefficients.read(), this->ramp_frames);
+		}
+
+		this->biquad.process(frames);
+	}
+
+	void reset() override {
+		this->biquad.reset();
+	}
+};
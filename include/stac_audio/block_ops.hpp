@@ -0,0 +1,278 @@
+#pragma once
+
+#include <span>
+#include <algorithm>
+#include <type_traits>
+#include <cstring>
+#include <cstddef>
+
+#include "dsp_declarations.hpp"
+#include "signals.hpp"
+#include "smoothed_value.hpp"
+#include "simd.hpp"
+
+/*
+ * Real-time safe block operations used by the audio callback to move samples
+ * between signals, waves, and the interleaved buffers of the audio device.
+ * None of them allocate, lock, or check bounds per sample.
+ */
+namespace dsp {
+/**
+ * @brief Interleave num_frames frames of planar channels into frames. A mono source
+ * is duplicated into every channel. Otherwise, missing channels are silent and
+ * extra channels are dropped
+ * @param channels Pointers to the first sample of each source channel
+ * @param num_source_channels Number of source channels
+ * @param frames Destination frames
+ */
+template<typename _sample_t, size_t _num_channels>
+void interleave(const _sample_t* const* const channels, const size_t num_source_channels,
+                const std::span<Frame<_sample_t, _num_channels>> frames) {
+	static_assert(sizeof(Frame<_sample_t, _num_channels>) == sizeof(_sample_t) * _num_channels,
+	              "Frame must be laid out as _num_channels contiguous samples");
+
+	_sample_t* const out = reinterpret_cast<_sample_t*>(frames.data());
+	const size_t num_frames = frames.size();
+
+	if (num_source_channels == 0) {
+		std::fill_n(out, num_frames * _num_channels, SAMPLE_SILENCE);
+		return;
+	}
+
+	if constexpr (_num_channels == 2) {
+		const _sample_t* const left  = channels[0];
+		const _sample_t* const right = (num_source_channels == 1) ? channels[0] : channels[1];
+		size_t i = 0;
+
+#if defined(STAC_AUDIO_SSE2)
+		if constexpr (std::is_same_v<_sample_t, float>) {
+			for (; i + 4 <= num_frames; i += 4) {
+				const __m128 l = _mm_loadu_ps(left + i);
+				const __m128 r = _mm_loadu_ps(right + i);
+
+				_mm_storeu_ps(out + i * 2,     _mm_unpacklo_ps(l, r));
+				_mm_storeu_ps(out + i * 2 + 4, _mm_unpackhi_ps(l, r));
+			}
+		}
+#endif
+
+		for (; i < num_frames; i++) {
+			out[i * 2]     = left[i];
+			out[i * 2 + 1] = right[i];
+		}
+	} else if constexpr (_num_channels == 1) {
+		std::copy_n(channels[0], num_frames, out);
+	} else {
+		for (size_t c = 0; c < _num_channels; c++) {
+			const _sample_t* const channel = (num_source_channels == 1) ? channels[0] :
+			                                 (c < num_source_channels) ? channels[c] : nullptr;
+
+			for (size_t i = 0; i < num_frames; i++) {
+				out[i * _num_channels + c] = (channel != nullptr) ? channel[i] : SAMPLE_SILENCE;
+			}
+		}
+	}
+}
+
+/**
+ * @brief  Fill frames from a signal starting at position, wrapping around to the
+ * beginning of the signal when its end is reached, e.g. to loop playback
+ * @param  signal Signal to read from. Mono is duplicated into every channel
+ * @param  position Index of the first frame to read
+ * @param  frames Destination frames
+ * @return Index of the frame after the last one read, i.e. the next position
+ */
+template<typename _sample_t, size_t _num_channels>
+size_t read_wrapped(const PlanarSignal<_sample_t>& signal, size_t position,
+                    const std::span<Frame<_sample_t, _num_channels>> frames) {
+	/// Maximum number of source channels read, the rest are dropped
+	static constexpr size_t MAX_SOURCE_CHANNELS = std::max<size_t>(_num_channels, 2);
+	const size_t num_frames = signal.num_frames();
+	const size_t num_source_channels = std::min(signal.num_channels(), MAX_SOURCE_CHANNELS);
+	const _sample_t* channels[MAX_SOURCE_CHANNELS] = { };
+
+	if (num_frames == 0) {
+		std::fill(frames.begin(), frames.end(), Frame<_sample_t, _num_channels>());
+		return 0;
+	}
+
+	position %= num_frames;
+
+	size_t frame_index = 0;
+
+	// one contiguous segment per pass, so there is no wrap check per sample
+	while (frame_index < frames.size()) {
+		const size_t len = std::min(frames.size() - frame_index, num_frames - position);
+
+		for (size_t c = 0; c < num_source_channels; c++) {
+			channels[c] = signal.channels[c].data() + position;
+		}
+
+		interleave(channels, num_source_channels, frames.subspan(frame_index, len));
+
+		frame_index += len;
+		position = (position + len == num_frames) ? 0 : position + len;
+	}
+
+	return position;
+}
+
+/**
+ * @brief Multiply every sample of the frames by a constant gain
+ */
+template<typename _sample_t, size_t _num_channels>
+void apply_gain(const std::span<Frame<_sample_t, _num_channels>> frames, const _sample_t gain) {
+	static_assert(sizeof(Frame<_sample_t, _num_channels>) == sizeof(_sample_t) * _num_channels,
+	              "Frame must be laid out as _num_channels contiguous samples");
+
+	if (gain == _sample_t(1)) {
+		return;
+	}
+
+	// a single flat loop over the samples, which the compiler vectorizes
+	_sample_t* const samples = reinterpret_cast<_sample_t*>(frames.data());
+	const size_t num_samples = frames.size() * _num_channels;
+
+	for (size_t i = 0; i < num_samples; i++) {
+		samples[i] *= gain;
+	}
+}
+
+/**
+ * @brief Copy frames into an interleaved device buffer of out_channels channels.
+ * Mono output is the average of the channels. Otherwise, extra output channels
+ * are silent and extra frame channels are dropped
+ * @param frames Frames to copy
+ * @param out Interleaved buffer, frames.size() * out_channels long
+ * @param out_channels Number of channels of the buffer
+ */
+template<typename _sample_t, size_t _num_channels>
+void write_interleaved(const std::span<const Frame<_sample_t, _num_channels>> frames, _sample_t* const out,
+                       const size_t out_channels) {
+	static_assert(sizeof(Frame<_sample_t, _num_channels>) == sizeof(_sample_t) * _num_channels,
+	              "Frame must be laid out as _num_channels contiguous samples");
+
+	const _sample_t* const in = reinterpret_cast<const _sample_t*>(frames.data());
+	const size_t num_frames = frames.size();
+
+	if (out_channels == _num_channels) {
+		std::memcpy(out, in, num_frames * _num_channels * sizeof(_sample_t));
+	} else if (out_channels == 1) {
+		const _sample_t scale = _sample_t(1) / static_cast<_sample_t>(_num_channels);
+
+		for (size_t i = 0; i < num_frames; i++) {
+			_sample_t sum = _sample_t(0);
+
+			for (size_t c = 0; c < _num_channels; c++) {
+				sum += in[i * _num_channels + c];
+			}
+
+			out[i] = sum * scale;
+		}
+	} else {
+		for (size_t i = 0; i < num_frames; i++) {
+			for (size_t c = 0; c < out_channels; c++) {
+				out[i * out_channels + c] = (c < _num_channels) ? in[i * _num_channels + c] : SAMPLE_SILENCE;
+			}
+		}
+	}
+}
+
+/**
+ * @brief Apply a smoothed gain and copy frames into an interleaved device buffer
+ * in a single pass. Once the gain has reached its target, the rest of the block
+ * is copied with a constant gain
+ */
+template<typename _sample_t, size_t _num_channels, typename _gain_t>
+void write_interleaved(const std::span<const Frame<_sample_t, _num_channels>> frames, _sample_t* const out,
+                       const size_t out_channels, SmoothedValue<_gain_t>& gain) {
+	const _sample_t* const in = reinterpret_cast<const _sample_t*>(frames.data());
+	const size_t num_frames = frames.size();
+	size_t i = 0;
+
+	if (out_channels == _num_channels) {
+		for (; i < num_frames && gain.is_smoothing(); i++) {
+			const _sample_t value = static_cast<_sample_t>(gain.next());
+
+			for (size_t c = 0; c < _num_channels; c++) {
+				out[i * _num_channels + c] = in[i * _num_channels + c] * value;
+			}
+		}
+
+		const _sample_t value = static_cast<_sample_t>(gain.get_current());
+		const size_t num_samples = num_frames * _num_channels;
+
+		for (size_t s = i * _num_channels; s < num_samples; s++) {
+			out[s] = in[s] * value;
+		}
+	} else {
+		write_interleaved(frames, out, out_channels);
+
+		for (; i < num_frames; i++) {
+			const _sample_t value = static_cast<_sample_t>(gain.next());
+
+			for (size_t c = 0; c < out_channels; c++) {
+				out[i * out_channels + c] *= value;
+			}
+		}
+	}
+}
+
+/**
+ * @brief Copy an interleaved device buffer of in_channels channels into frames,
+ * e.g. the input buffer of a duplex stream. Mono input is duplicated into every
+ * channel. Otherwise, missing channels are silent and extra channels are dropped
+ */
+template<typename _sample_t, size_t _num_channels>
+void read_interleaved(const _sample_t* const in, const size_t in_channels,
+                      const std::span<Frame<_sample_t, _num_channels>> frames) {
+	static_assert(sizeof(Frame<_sample_t, _num_channels>) == sizeof(_sample_t) * _num_channels,
+	              "Frame must be laid out as _num_channels contiguous samples");
+
+	_sample_t* const out = reinterpret_cast<_sample_t*>(frames.data());
+	const size_t num_frames = frames.size();
+
+	if (in_channels == _num_channels) {
+		std::memcpy(out, in, num_frames * _num_channels * sizeof(_sample_t));
+	} else {
+		for (size_t i = 0; i < num_frames; i++) {
+			for (size_t c = 0; c < _num_channels; c++) {
+				out[i * _num_channels + c] = (in_channels == 1) ? in[i] :
+				                             (c < in_channels) ? in[i * in_channels + c] : SAMPLE_SILENCE;
+			}
+		}
+	}
+}
+
+/**
+ * @brief  Fill frames from interleaved samples viewed in place, e.g. a memory mapped
+ * file, starting at position and wrapping around to the beginning at the end
+ * @param  view Samples to read from. Mono is duplicated into every channel
+ * @param  position Index of the first frame to read
+ * @param  frames Destination frames
+ * @return Index of the frame after the last one read, i.e. the next position
+ */
+template<typename _sample_t, size_t _num_channels>
+size_t read_wrapped(const SignalView<_sample_t>& view, size_t position,
+                    const std::span<Frame<_sample_t, _num_channels>> frames) {
+	if (view.empty() || view.num_channels == 0) {
+		std::fill(frames.begin(), frames.end(), Frame<_sample_t, _num_channels>());
+		return 0;
+	}
+
+	position %= view.num_frames;
+
+	size_t frame_index = 0;
+
+	while (frame_index < frames.size()) {
+		const size_t len = std::min(frames.size() - frame_index, view.num_frames - position);
+
+		read_interleaved(view.samples + position * view.num_channels, view.num_channels, frames.subspan(frame_index, len));
+
+		frame_index += len;
+		position = (position + len == view.num_frames) ? 0 : position + len;
+	}
+
+	return position;
+}
+} // namespace dsp
@@ -1,64 +1,66 @@
-#pragma once
-
-#include <cmath>
-#include <fstream>
-
-#include "dsp_declarations.hpp"
-#include "signals.hpp"
-
-namespace dsp::utils {
-/**
-* @brief Return the value, in dB, of a sample's amplitude
-*
-* @param sample the sample, in amplitude scale, to get the dB value of
-*/
-template<typename _sample_t>
-_sample_t amp_to_db(_sample_t sample) {
-	return static_cast<_sample_t>(20 * std::log10(sample));
-}
-/**
-* @brief Return the value, in amplitude scale, of a sample's dB value
-*
-* @param sample the sample, in dB, to get the amplitude scale value of
-*/
-template<typename _sample_t>
-_sample_t db_to_amp(_sample_t sample) {
-	return static_cast<_sample_t>(std::pow(10, sample / 20));
-}
-/**
-* @brief Write the specified signal's frame data to the specified file.
-* Data will be in csv format with left channel data as the first element
-* of each line and right channel data as the second element of each line.
-* Will overwrite any existing data that is contained with the file.
-*
-* THROWS std::ifstream::failure if file is unable to be opened/written to
-*
-* @param signal the signal to write to a file
-* @param file_path the path of the file to write the signal to
-*/
-template<typename _sample_t>
-void write_signal_to_file(const Signal<_sample_t>& signal, const std::string& file_path) {
-	std::fstream file;
-	file.exceptions(std::ios_base::badbit);
-
-	file.open(file_path, std::ios_base::out | std::ios_base::trunc);
-
-	const std::vector<Frame<_sample_t>>& frames = signal.frames();
-
-	for (const Frame<_sample_t>& frame : frames) {
-		file << frame.get_left_sample() << ", " << frame.get_right_sample() << "\n";
-		file.flush();
-	}
-
-	file.close();
-}
-/**
- * @brief Get a signal sample index from a time in ms
- * @param sample_rate Sample rate of the signal
- * @param time Time in ms
- * @return Sample index corresponding to the time and sample rate
- */
-constexpr size_t sample_index_from_time(const sample_rate_t get_sample_rate, const time_ms_t time) {
-	return static_cast<size_t>(time * (get_sample_rate / 1000.0));
-}
-} // namespace dsp::utils
+#pragma once
+
+#include <cmath>
+#include <fstream>
+
+#include "dsp_declarations.hpp"
+#include "signals.hpp"
+
+namespace dsp::utils {
+/**
+* @brief Return the value, in dB, of a sample's amplitude
+*
+* @param sample the sample, in amplitude scale, to get the dB value of
+*/
+template<typename _sample_t>
+_sample_t amp_to_db(_sample_t sample) {
+	return static_cast<_sample_t>(20 * std::log10(sample));
+}
+/**
+* @brief Return the value, in amplitude scale, of a sample's dB value
+*
+* @param sample the sample, in dB, to get the amplitude scale value of
+*/
+template<typename _sample_t>
+_sample_t db_to_amp(_sample_t sample) {
+	return static_cast<_sample_t>(std::pow(10, sample / 20));
+}
+/**
+* @brief Write the specified signal's frame data to the specified file.
+* Data will be in csv format with one line per frame, where each line contains
+* the samples of every channel in channel order (left then right for stereo).
+* Will overwrite any existing data that is contained with the file.
+*
+* THROWS std::ifstream::failure if file is unable to be opened/written to
+*
+* @param signal the signal to write to a file
+* @param file_path the path of the file to write the signal to
+*/
+template<typename _sample_t, std::size_t _num_channels>
+void write_signal_to_file(const Signal<_sample_t, _num_channels>& signal, const std::string& file_path) {
+	std::fstream file;
+	file.exceptions(std::ios_base::badbit);
+
+	file.open(file_path, std::ios_base::out | std::ios_base::trunc);
+
+	for (const Frame<_sample_t, _num_channels>& frame : signal.frames) {
+		for (size_t c = 0; c < _num_channels; c++) {
+			file << ((c == 0) ? "" : ", ") << frame[c];
+		}
+
+		file << "\n";
+	}
+
+	file.flush();
+	file.close();
+}
+/**
+ * @brief Get a signal sample index from a time in ms
+ * @param sample_rate Sample rate of the signal
+ * @param time Time in ms
+ * @return Sample index corresponding to the time and sample rate
+ */
+constexpr size_t sample_index_from_time(const sample_rate_t get_sample_rate, const time_ms_t time) {
+	return static_cast<size_t>(time * (get_sample_rate / 1000.0));
+}
+} // namespace dsp::utils
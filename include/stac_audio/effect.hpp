@@ -1,7 +1,94 @@
 #pragma once
 
+#include <span>
+#include <algorithm>
+#include <utility>
+#include <cstddef>
+
+#include "dsp_declarations.hpp"
 #include "signals.hpp"
 
+/**
+ * @brief Interface of an audio effect that processes blocks of samples in place
+ * on the audio thread. Implementations must not allocate, lock, or block in
+ * process or process_planar.
+ */
+template<typename _sample_t, size_t _num_channels = dsp::NUM_CHANNELS>
 class Effect {
-	template<typename _sample_t, size_t
+public:
+	using sample_type = _sample_t;
+	using frame_type  = dsp::Frame<_sample_t, _num_channels>;
+
+	static constexpr size_t num_channels = _num_channels;
+
+private:
+	/// Number of frames interleaved at once by the default process_planar
+	static constexpr size_t PLANAR_BLOCK_FRAMES = 64;
+
+public:
+	virtual ~Effect() = default;
+
+	/**
+	 * @brief Process interleaved frames, such as a dsp::Wave, in place
+	 */
+	virtual void process(const std::span<frame_type> frames) = 0;
+
+	/**
+	 * @brief Process planar channels, such as those of a dsp::PlanarSignal, in place.
+	 * The default implementation interleaves blocks of the channels into a buffer
+	 * on the stack and processes them with process
+	 * @param channels _num_channels channels of equal length
+	 */
+	virtual void process_planar(const std::span<const std::span<_sample_t>> channels) {
+		dsp::Wave<_sample_t, PLANAR_BLOCK_FRAMES, _num_channels> block;
+		const size_t num_frames = channels.empty() ? 0 : channels[0].size();
+
+		for (size_t offset = 0; offset < num_frames; offset += PLANAR_BLOCK_FRAMES) {
+			const size_t len = std::min(PLANAR_BLOCK_FRAMES, num_frames - offset);
+
+			for (size_t i = 0; i < len; i++) {
+				for (size_t c = 0; c < _num_channels; c++) {
+					block[i][c] = channels[c][offset + i];
+				}
+			}
+
+			this->process(std::span<frame_type>(block.data(), len));
+
+			for (size_t i = 0; i < len; i++) {
+				for (size_t c = 0; c < _num_channels; c++) {
+					channels[c][offset + i] = block[i][c];
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief Clear any state kept between blocks, e.g. when playback is restarted
+	 */
+	virtual void reset() { }
+};
+
+/**
+ * @brief Effect that forwards to a DSP processor with a process(std::span<frame_type>)
+ * method, such as dsp::Biquad or dsp::Equalizer, so that it may be used in an EffectChain.
+ * The processor must not be retuned while the chain is running. Use a BiquadEffect
+ * or an EqualizerEffect for filters that are
+ */
+template<typename _processor_t, typename _sample_t = dsp::sample_t, size_t _num_channels = dsp::NUM_CHANNELS>
+class ProcessorEffect : public Effect<_sample_t, _num_channels> {
+public:
+	_processor_t processor;
+
+	template<typename... _args_t>
+	explicit ProcessorEffect(_args_t&&... args) :
+		processor(std::forward<_args_t>(args)...)
+	{ }
+
+	void process(const std::span<typename Effect<_sample_t, _num_channels>::frame_type> frames) override {
+		this->processor.process(frames);
+	}
+
+	void reset() override {
+		this->processor.reset();
+	}
 };
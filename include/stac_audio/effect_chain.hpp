@@ -0,0 +1,233 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <span>
+#include <cassert>
+#include <cstddef>
+#include <lfmq/lock_free_queue.hpp>
+
+#include "effect.hpp"
+#include "tracing.hpp"
+
+/**
+ * @brief Ordered list of effects that are applied one after another.
+ *
+ * A chain is built and modified on the control thread, and is immutable once it
+ * has been submitted to an EffectChainHost. To insert, remove, or reorder effects
+ * of a running chain, copy the chain, modify the copy, and submit the copy. The
+ * effects are shared between the copies, so their state carries over.
+ */
+template<typename _sample_t, size_t _num_channels = dsp::NUM_CHANNELS>
+class EffectChain {
+public:
+	using effect_type = Effect<_sample_t, _num_channels>;
+	using frame_type  = typename effect_type::frame_type;
+
+private:
+	std::vector<std::shared_ptr<effect_type>> effects;
+
+public:
+	EffectChain() = default;
+
+	size_t size() const {
+		return this->effects.size();
+	}
+
+	const std::shared_ptr<effect_type>& at(const size_t index) const {
+		return this->effects.at(index);
+	}
+
+	void add(std::shared_ptr<effect_type> effect) {
+		this->effects.push_back(std::move(effect));
+	}
+
+	void insert(const size_t index, std::shared_ptr<effect_type> effect) {
+		assert(index <= this->effects.size());
+
+		this->effects.insert(this->effects.begin() + index, std::move(effect));
+	}
+
+	void remove(const size_t index) {
+		assert(index < this->effects.size());
+
+		this->effects.erase(this->effects.begin() + index);
+	}
+
+	/**
+	 * @brief Move the effect at index from so that it ends up at index to
+	 */
+	void move(const size_t from, const size_t to) {
+		assert(from < this->effects.size() && to < this->effects.size());
+
+		std::shared_ptr<effect_type> effect = std::move(this->effects[from]);
+
+		this->effects.erase(this->effects.begin() + from);
+		this->effects.insert(this->effects.begin() + to, std::move(effect));
+	}
+
+	void process(const std::span<frame_type> frames) const {
+		for (size_t i = 0; i < this->effects.size(); i++) {
+			// the argument is the position of the effect in the chain
+			STAC_TRACE_SCOPE("effect", i);
+			this->effects[i]->process(frames);
+		}
+	}
+
+	void process_planar(const std::span<const std::span<_sample_t>> channels) const {
+		for (size_t i = 0; i < this->effects.size(); i++) {
+			STAC_TRACE_SCOPE("effect", i);
+			this->effects[i]->process_planar(channels);
+		}
+	}
+
+	void reset() const {
+		for (const std::shared_ptr<effect_type>& effect : this->effects) {
+			effect->reset();
+		}
+	}
+};
+
+/**
+ * @brief Runs an EffectChain on the audio thread and replaces it with chains
+ * submitted by the control thread, without allocating or locking on the audio
+ * thread.
+ *
+ * Submitted chains are passed to the audio thread through a lock-free queue. The
+ * audio thread switches to the newest one at the start of its next block and
+ * passes the chain it replaced back through a second queue, so that chains, and
+ * any effects that were removed from them, are only ever destroyed by the
+ * control thread, in submit or collect.
+ */
+template<typename _sample_t, size_t _num_channels = dsp::NUM_CHANNELS>
+class EffectChainHost {
+public:
+	using chain_type = EffectChain<_sample_t, _num_channels>;
+	using frame_type = typename chain_type::frame_type;
+
+	/// Capacity of the queues between the control and audio threads
+	static constexpr size_t QUEUE_CAPACITY = 8;
+
+private:
+	/// Chains submitted by the control thread that the audio thread has not switched to yet
+	lfmq::SpscQueue<chain_type*, QUEUE_CAPACITY> pending_chains;
+	/// Chains that the audio thread no longer uses, to be destroyed by the control thread
+	lfmq::SpscQueue<chain_type*, QUEUE_CAPACITY> retired_chains;
+	/// Audio thread only. Chain being run
+	chain_type*                                  active_chain = nullptr;
+	/// Control thread only. Most recently submitted chain
+	chain_type*                                  latest_chain = nullptr;
+	/// Control thread only. Number of chains that have been submitted but not destroyed
+	size_t                                       num_live_chains = 0;
+
+public:
+	EffectChainHost() = default;
+
+	EffectChainHost(const EffectChainHost& rhs) = delete;
+	EffectChainHost& operator=(const EffectChainHost& rhs) = delete;
+
+	/**
+	 * @brief Destroy every chain. The audio thread must no longer be processing
+	 */
+	~EffectChainHost() {
+		chain_type* chain = nullptr;
+
+		while (this->pending_chains.pop(&chain)) {
+			delete chain;
+		}
+
+		this->collect();
+		delete this->active_chain;
+	}
+
+	/**
+	 * @brief  Control thread only. Replace the running chain at the start of the audio thread's next block
+	 * @param  chain Chain to run. Only taken when the submission succeeds
+	 * @return Whether the chain was submitted. Fails when the audio thread has not
+	 * caught up with earlier submissions, in which case chain is left untouched and
+	 * may be submitted again later
+	 */
+	bool submit(std::unique_ptr<chain_type>&& chain) {
+		this->collect();
+
+		// the active chain and every chain in the queues are live, so at most
+		// QUEUE_CAPACITY - 1 may be live for neither queue to be full
+		if (this->num_live_chains >= QUEUE_CAPACITY - 1 || !this->pending_chains.push(chain.get())) {
+			return false;
+		}
+
+		this->latest_chain = chain.release();
+		this->num_live_chains++;
+
+		return true;
+	}
+
+	/**
+	 * @brief  Control thread only. Destroy the chains that the audio thread has replaced
+	 * @return Number of chains destroyed
+	 */
+	size_t collect() {
+		chain_type* chain = nullptr;
+		size_t num_collected = 0;
+
+		while (this->retired_chains.pop(&chain)) {
+			delete chain;
+			num_collected++;
+		}
+
+		this->num_live_chains -= num_collected;
+
+		return num_collected;
+	}
+
+	/**
+	 * @brief  Control thread only. Most recently submitted chain, to be copied and
+	 * modified when building the next one
+	 * @return Latest chain, or nullptr if none has been submitted
+	 */
+	const chain_type* latest() const {
+		return this->latest_chain;
+	}
+
+	/**
+	 * @brief Audio thread only. Switch to the newest submitted chain, if there is one
+	 */
+	void update() {
+		chain_type* chain = nullptr;
+
+		while (this->pending_chains.pop(&chain)) {
+			if (this->active_chain != nullptr) {
+				this->retired_chains.push(this->active_chain);
+			}
+
+			this->active_chain = chain;
+		}
+	}
+
+	/**
+	 * @brief Audio thread only. Switch to the newest submitted chain and process interleaved frames in place
+	 */
+	void process(const std::span<frame_type> frames) {
+		this->update();
+
+		if (this->active_chain != nullptr) {
+			this->active_chain->process(frames);
+		}
+	}
+
+	template<size_t _capacity>
+	void process(dsp::Wave<_sample_t, _capacity, _num_channels>& wave) {
+		this->process(std::span<frame_type>(wave));
+	}
+
+	/**
+	 * @brief Audio thread only. Switch to the newest submitted chain and process planar channels in place
+	 */
+	void process_planar(const std::span<const std::span<_sample_t>> channels) {
+		this->update();
+
+		if (this->active_chain != nullptr) {
+			this->active_chain->process_planar(channels);
+		}
+	}
+};
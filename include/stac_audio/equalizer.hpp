@@ -0,0 +1,367 @@
+#pragma once
+
+#include <array>
+#include <span>
+#include <cmath>
+#include <algorithm>
+#include <type_traits>
+#include <cassert>
+#include <cstddef>
+
+#include "dsp_declarations.hpp"
+#include "signals.hpp"
+#include "biquad.hpp"
+#include "simd.hpp"
+
+namespace dsp {
+/**
+ * @brief Parametric equalizer of up to _max_bands biquads in series, applied to
+ * every channel of interleaved frames.
+ *
+ * Each frame passes through every band before the next frame is read, so the
+ * frame stays in registers for the whole cascade and band k of one frame may
+ * overlap with band k + 1 of the previous frame in the pipeline. Coefficients
+ * and states are stored band after band in lane-width arrays, so that a band is
+ * a few aligned loads. When SSE2 is available, float frames of up to 4 channels
+ * run one channel per lane. process_frame filters a single frame, so that the
+ * equalizer may be fused with other stages in a dsp::Pipeline.
+ *
+ * The setters change the coefficients in place and must not be called while
+ * another thread is filtering. To retune an equalizer that is running on the
+ * audio thread, use an EqualizerEffect, which publishes the coefficients of every
+ * band through a dsp::TripleBuffer and ramps to them on the audio thread.
+ */
+template<typename _sample_t, size_t _max_bands, size_t _num_channels = NUM_CHANNELS>
+class Equalizer {
+public:
+	using frame_type = Frame<_sample_t, _num_channels>;
+
+	static constexpr size_t max_bands    = _max_bands;
+	static constexpr size_t num_channels = _num_channels;
+
+	struct Band {
+		BiquadType  type      = BiquadType::UNKNOWN;
+		frequency_t f0        = frequency_t();
+		bandwidth_t q         = bandwidth_t();
+		gain_db_t   peak_gain = gain_db_t();
+	};
+
+private:
+	/// Number of lanes of the coefficient and state arrays, which is at least 4 so
+	/// that a band of float coefficients may be loaded into an SSE register
+	static constexpr size_t LANES = std::max<size_t>(_num_channels, 4);
+
+	struct alignas(16) BandCoefficients {
+		std::array<_sample_t, LANES> a0;
+		std::array<_sample_t, LANES> a1;
+		std::array<_sample_t, LANES> a2;
+		std::array<_sample_t, LANES> b1;
+		std::array<_sample_t, LANES> b2;
+	};
+
+	struct alignas(16) BandState {
+		std::array<_sample_t, LANES> z1 = { };
+		std::array<_sample_t, LANES> z2 = { };
+	};
+
+	sample_rate_t                              sample_rate;
+	size_t                                     num_bands = 0;
+	std::array<Band, _max_bands>               bands;
+	std::array<BandCoefficients, _max_bands>   coefficients;
+	std::array<BandState, _max_bands>          states;
+	/// Coefficients of every band that the ramp ends at
+	std::array<BiquadCoefficients<_sample_t>, _max_bands> target_coefficients;
+	/// Number of frames until the target coefficients are reached
+	size_t                                     ramp_remaining = 0;
+
+public:
+	/// Number of frames filtered with each step of a coefficient ramp
+	static constexpr size_t RAMP_STEP_FRAMES = 16;
+
+	explicit Equalizer(const sample_rate_t sample_rate = SAMPLE_RATE) :
+		sample_rate(sample_rate)
+	{ }
+
+	sample_rate_t get_sample_rate() const {
+		return this->sample_rate;
+	}
+
+	/**
+	 * @brief Change the sample rate and recompute the coefficients of every band
+	 */
+	void set_sample_rate(const sample_rate_t sample_rate) {
+		this->sample_rate = sample_rate;
+
+		for (size_t i = 0; i < this->num_bands; i++) {
+			this->commit(i);
+		}
+	}
+
+	size_t get_num_bands() const {
+		return this->num_bands;
+	}
+
+	/**
+	 * @brief Set the number of bands that are applied. New bands pass the input through until they are set
+	 */
+	void set_num_bands(const size_t num_bands) {
+		assert(num_bands <= _max_bands);
+
+		const size_t old_num_bands = this->num_bands;
+
+		this->num_bands = num_bands;
+
+		for (size_t i = old_num_bands; i < num_bands; i++) {
+			this->bands[i] = Band();
+			this->states[i] = BandState();
+			this->commit(i);
+		}
+	}
+
+	const Band& get_band(const size_t index) const {
+		return this->bands[index];
+	}
+
+	/**
+	 * @brief Set the parameters of a band and recompute its coefficients. The band's state
+	 * is kept, and a coefficient ramp is stopped where it is
+	 */
+	void set_band(const size_t index, const Band& band) {
+		assert(index < this->num_bands);
+
+		this->bands[index] = band;
+		this->commit(index);
+	}
+
+	/**
+	 * @brief Use precomputed coefficients for a band, e.g. ones computed off the audio thread
+	 */
+	void set_band_coefficients(const size_t index, const BiquadCoefficients<_sample_t>& coefficients) {
+		assert(index < this->num_bands);
+
+		this->fill_band(index, coefficients);
+		this->ramp_remaining = 0;
+	}
+
+	/**
+	 * @return Coefficients a band is currently filtering with
+	 */
+	BiquadCoefficients<_sample_t> get_band_coefficients(const size_t index) const {
+		const BandCoefficients& band = this->coefficients[index];
+		BiquadCoefficients<_sample_t> coefficients;
+
+		coefficients.a0 = band.a0[0];
+		coefficients.a1 = band.a1[0];
+		coefficients.a2 = band.a2[0];
+		coefficients.b1 = band.b1[0];
+		coefficients.b2 = band.b2[0];
+
+		return coefficients;
+	}
+
+	/**
+	 * @brief Move the coefficients of every band linearly to the targets over the next
+	 * num_frames frames filtered through process(std::span<frame_type>), in steps of
+	 * RAMP_STEP_FRAMES, so that the change is not heard as a click or zipper noise
+	 * @param targets Coefficients to end at, of which the first get_num_bands() are used
+	 * @param num_frames Length of the ramp. 0 changes the coefficients immediately
+	 */
+	void ramp_to(const std::array<BiquadCoefficients<_sample_t>, _max_bands>& targets, const size_t num_frames) {
+		this->target_coefficients = targets;
+		this->ramp_remaining = num_frames;
+
+		if (num_frames == 0) {
+			for (size_t i = 0; i < this->num_bands; i++) {
+				this->fill_band(i, targets[i]);
+			}
+		}
+	}
+
+	bool is_ramping() const {
+		return this->ramp_remaining > 0;
+	}
+
+	/**
+	 * @brief Configure a graphic equalizer of num_bands PEAK bands at 0 dB, spaced
+	 * logarithmically from lowest to highest, e.g. 31 bands from 20 Hz to 20 kHz
+	 * @param num_bands Number of bands
+	 * @param lowest Center frequency of the first band
+	 * @param highest Center frequency of the last band
+	 */
+	void configure_graphic(const size_t num_bands, const frequency_t lowest, const frequency_t highest) {
+		assert(num_bands > 0 && lowest > 0.0 && highest >= lowest);
+
+		this->set_num_bands(num_bands);
+
+		const double octaves = (num_bands > 1) ? std::log2(highest / lowest) / static_cast<double>(num_bands - 1) : 1.0;
+		// Q of a band whose bandwidth spans the distance to its neighbours
+		const double q = std::sqrt(std::exp2(octaves)) / (std::exp2(octaves) - 1.0);
+
+		for (size_t i = 0; i < num_bands; i++) {
+			this->set_band(i, { BiquadType::PEAK, lowest * std::exp2(octaves * static_cast<double>(i)), q, 0.0 });
+		}
+	}
+
+	/**
+	 * @brief Clear the state of every band
+	 */
+	void reset() {
+		this->states.fill(BandState());
+	}
+
+	/**
+	 * @brief Filter every channel of one frame in place through every band
+	 */
+	void process_frame(frame_type& frame) {
+		static_assert(sizeof(frame_type) == sizeof(_sample_t) * _num_channels,
+		              "Frame must be laid out as _num_channels contiguous samples");
+
+		_sample_t* const samples = reinterpret_cast<_sample_t*>(&frame);
+
+#if defined(STAC_AUDIO_SSE2)
+		if constexpr (std::is_same_v<_sample_t, float> && _num_channels <= 4) {
+			this->process_frame_sse(samples);
+			return;
+		}
+#endif
+
+		for (size_t b = 0; b < this->num_bands; b++) {
+			const BandCoefficients& c = this->coefficients[b];
+			BandState& s = this->states[b];
+
+			for (size_t ch = 0; ch < _num_channels; ch++) {
+				const _sample_t in = samples[ch];
+				const _sample_t out = in * c.a0[ch] + s.z1[ch];
+
+				s.z1[ch] = in * c.a1[ch] + s.z2[ch] - c.b1[ch] * out;
+				s.z2[ch] = in * c.a2[ch] - c.b2[ch] * out;
+				samples[ch] = out;
+			}
+		}
+	}
+
+	/**
+	 * @brief Filter every channel of interleaved frames in place through every band,
+	 * advancing the coefficient ramp if there is one
+	 */
+	void process(const std::span<frame_type> frames) {
+		if (this->num_bands == 0) {
+			return;
+		}
+
+		size_t frame_index = 0;
+
+		while (this->ramp_remaining > 0 && frame_index < frames.size()) {
+			const size_t len = std::min({ RAMP_STEP_FRAMES, this->ramp_remaining, frames.size() - frame_index });
+			const _sample_t t = static_cast<_sample_t>(len) / static_cast<_sample_t>(this->ramp_remaining);
+
+			this->ramp_remaining -= len;
+
+			for (size_t b = 0; b < this->num_bands; b++) {
+				this->fill_band(b, (this->ramp_remaining == 0) ? this->target_coefficients[b]
+					: this->get_band_coefficients(b).lerp(this->target_coefficients[b], t));
+			}
+
+			for (frame_type& frame : frames.subspan(frame_index, len)) {
+				this->process_frame(frame);
+			}
+
+			frame_index += len;
+		}
+
+		for (frame_type& frame : frames.subspan(frame_index)) {
+			this->process_frame(frame);
+		}
+	}
+
+	template<size_t _capacity>
+	void process(Wave<_sample_t, _capacity, _num_channels>& wave) {
+		this->process(std::span<frame_type>(wave));
+	}
+
+	/**
+	 * @brief Filter the samples of one channel in place through every band, e.g. a dsp::PlanarSignal channel
+	 * @param samples Samples to filter
+	 * @param channel Channel whose state is used
+	 */
+	void process(const std::span<_sample_t> samples, const size_t channel) {
+		assert(channel < _num_channels);
+
+		for (_sample_t& sample : samples) {
+			_sample_t value = sample;
+
+			for (size_t b = 0; b < this->num_bands; b++) {
+				const BandCoefficients& c = this->coefficients[b];
+				BandState& s = this->states[b];
+				const _sample_t out = value * c.a0[channel] + s.z1[channel];
+
+				s.z1[channel] = value * c.a1[channel] + s.z2[channel] - c.b1[channel] * out;
+				s.z2[channel] = value * c.a2[channel] - c.b2[channel] * out;
+				value = out;
+			}
+
+			sample = value;
+		}
+	}
+
+private:
+	void commit(const size_t index) {
+		const Band& band = this->bands[index];
+
+		this->set_band_coefficients(index, BiquadCoefficients<_sample_t>::compute(band.type, this->sample_rate, band.f0,
+		                                                                         band.q, band.peak_gain));
+	}
+
+	void fill_band(const size_t index, const BiquadCoefficients<_sample_t>& coefficients) {
+		BandCoefficients& band = this->coefficients[index];
+
+		band.a0.fill(coefficients.a0);
+		band.a1.fill(coefficients.a1);
+		band.a2.fill(coefficients.a2);
+		band.b1.fill(coefficients.b1);
+		band.b2.fill(coefficients.b2);
+	}
+
+#if defined(STAC_AUDIO_SSE2)
+	void process_frame_sse(float* const frame) {
+		__m128 value;
+
+		if constexpr (_num_channels == 4) {
+			value = _mm_loadu_ps(frame);
+		} else if constexpr (_num_channels == 2) {
+			value = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(frame));
+		} else {
+			alignas(16) float lanes[4] = { };
+
+			std::copy_n(frame, _num_channels, lanes);
+			value = _mm_load_ps(lanes);
+		}
+
+		for (size_t b = 0; b < this->num_bands; b++) {
+			const BandCoefficients& c = this->coefficients[b];
+			BandState& s = this->states[b];
+			const __m128 z1 = _mm_load_ps(s.z1.data());
+			const __m128 z2 = _mm_load_ps(s.z2.data());
+			const __m128 out = _mm_add_ps(_mm_mul_ps(value, _mm_load_ps(c.a0.data())), z1);
+
+			_mm_store_ps(s.z1.data(), _mm_sub_ps(_mm_add_ps(_mm_mul_ps(value, _mm_load_ps(c.a1.data())), z2),
+			                                     _mm_mul_ps(_mm_load_ps(c.b1.data()), out)));
+			_mm_store_ps(s.z2.data(), _mm_sub_ps(_mm_mul_ps(value, _mm_load_ps(c.a2.data())),
+			                                     _mm_mul_ps(_mm_load_ps(c.b2.data()), out)));
+			value = out;
+		}
+
+		if constexpr (_num_channels == 4) {
+			_mm_storeu_ps(frame, value);
+		} else if constexpr (_num_channels == 2) {
+			_mm_storel_pi(reinterpret_cast<__m64*>(frame), value);
+		} else {
+			alignas(16) float lanes[4];
+
+			_mm_store_ps(lanes, value);
+			std::copy_n(lanes, _num_channels, frame);
+		}
+	}
+#endif
+};
+} // namespace dsp
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <array>
+#include <span>
+#include <cstddef>
+
+#include "dsp_declarations.hpp"
+#include "effect.hpp"
+#include "biquad.hpp"
+#include "equalizer.hpp"
+#include "triple_buffer.hpp"
+
+/**
+ * @brief Equalizer effect whose bands may be changed by the control thread while
+ * the audio thread is filtering with it.
+ *
+ * The control thread edits its own copy of the equalizer, which computes the
+ * coefficients of every band, and publishes them through a dsp::TripleBuffer.
+ * At the start of its next block, the audio thread takes the latest coefficients
+ * and ramps every band to them, as BiquadEffect does for a single filter.
+ */
+template<typename _sample_t, size_t _max_bands, size_t _num_channels = dsp::NUM_CHANNELS>
+class EqualizerEffect : public Effect<_sample_t, _num_channels> {
+public:
+	using equalizer_type    = dsp::Equalizer<_sample_t, _max_bands, _num_channels>;
+	using coefficients_type = dsp::BiquadCoefficients<_sample_t>;
+	using band_type         = typename equalizer_type::Band;
+	using frame_type        = typename Effect<_sample_t, _num_channels>::frame_type;
+
+	/// Default number of frames over which the bands move to new coefficients
+	static constexpr size_t DEFAULT_RAMP_FRAMES = 512;
+
+	/**
+	 * @brief Bands published to the audio thread
+	 */
+	struct Settings {
+		size_t                                       num_bands = 0;
+		std::array<coefficients_type, _max_bands>    coefficients;
+	};
+
+private:
+	/// Audio thread only once the effect is running
+	equalizer_type              equalizer;
+	dsp::TripleBuffer<Settings> pending_settings;
+	/// Control thread only. Bands of the latest settings published
+	equalizer_type              control;
+	size_t                      ramp_frames;
+
+public:
+	explicit EqualizerEffect(const dsp::sample_rate_t sample_rate = dsp::SAMPLE_RATE,
+	                         const size_t ramp_frames = DEFAULT_RAMP_FRAMES) :
+		equalizer(sample_rate),
+		control(sample_rate),
+		ramp_frames(ramp_frames)
+	{ }
+
+	/**
+	 * @brief Control thread only. Change the sample rate and recompute the coefficients of every band
+	 */
+	void set_sample_rate(const dsp::sample_rate_t sample_rate) {
+		this->control.set_sample_rate(sample_rate);
+		this->publish();
+	}
+
+	/**
+	 * @brief Control thread only. Set the number of bands that are applied. New bands
+	 * pass the input through until they are set
+	 */
+	void set_num_bands(const size_t num_bands) {
+		this->control.set_num_bands(num_bands);
+		this->publish();
+	}
+
+	/**
+	 * @brief Control thread only. Set the parameters of a band. Real-time safe, so it may
+	 * be called as often as a slider moves
+	 */
+	void set_band(const size_t index, const band_type& band) {
+		this->control.set_band(index, band);
+		this->publish();
+	}
+
+	/**
+	 * @brief Control thread only. Configure a graphic equalizer, as equalizer_type::configure_graphic does
+	 */
+	void configure_graphic(const size_t num_bands, const dsp::frequency_t lowest, const dsp::frequency_t highest) {
+		this->control.configure_graphic(num_bands, lowest, highest);
+		this->publish();
+	}
+
+	/**
+	 * @brief Control thread only. Parameters last given to a band
+	 */
+	const band_type& get_band(const size_t index) const {
+		return this->control.get_band(index);
+	}
+
+	/**
+	 * @brief Control thread only. Number of bands last published
+	 */
+	size_t get_num_bands() const {
+		return this->control.get_num_bands();
+	}
+
+	void process(const std::span<frame_type> frames) override {
+		if (this->pending_settings.update()) {
+			const Settings& settings = this->pending_settings.read();
+
+			// added bands start from passing the input through, with a clear state
+			if (settings.num_bands != this->equalizer.get_num_bands()) {
+				this->equalizer.set_num_bands(settings.num_bands);
+			}
+
+			this->equalizer.ramp_to(settings.coefficients, this->ramp_frames);
+		}
+
+		this->equalizer.process(frames);
+	}
+
+	void reset() override {
+		this->equalizer.reset();
+	}
+
+private:
+	void publish() {
+		Settings& settings = this->pending_settings.write_buffer();
+
+		settings.num_bands = this->control.get_num_bands();
+
+		for (size_t i = 0; i < settings.num_bands; i++) {
+			settings.coefficients[i] = this->control.get_band_coefficients(i);
+		}
+
+		this->pending_settings.publish();
+	}
+};
@@ -3,85 +3,129 @@
 #include <fftw3.h>
 #include <type_traits>
 #include <concepts>
+#include <complex>
+#include <span>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
 
-// Idea: could make this take in a dimension parameter in the future
-template<typename _sample_t> requires std::convertible_to<_sample_t, double>
-class R2CConverter {
-private:
-	fftw_plan plan;
+#include "fftw_traits.hpp"
+#include "fft_wisdom.hpp"
+#include "fft_plan_registry.hpp"
 
-public:
-	void execute() {
-		fftw_execute(plan);
-	}
-};
-
-/*
- * TODO
- * Have the user be able to pass in the buffer of real samples
- * as well as a buffer of complex samples
- * so that the audio thread's wave may be passed in as an argument.
- * A container of complex numbers also must be added to the AudioThreadData struct,
- * and neither of these containers will be owned by the FFTConverter.
- * TODO
- * Need to check whether the Frame structure can be casted into a double[2]
- * for the purposes of using it within fftw
+/**
+ * Converts blocks of real samples to their spectrum and back through fftw, in the
+ * precision of _sample_t (fftwf_* for float, fftw_* for double).
+ * The fftw plans are shared with every other converter of the same size and
+ * stride through dsp::fft::PlanRegistry. The real and complex buffers belong
+ * to the caller (for example one dsp::PlanarSignal channel and a vector of
+ * num_real_samples / 2 + 1 complex samples) and are passed into every call through
+ * fftw's new-array execute functions, so that neither forward nor inverse allocates
+ * or copies. The buffers must have the layout the converter was constructed with.
+ *
+ * A converter may also transform a batch of blocks in a single call, for example
+ * every channel of an interleaved buffer or many consecutive blocks of a long
+ * channel, which replaces many small execute calls with one large one. The
+ * layouts of a batch are described by dsp::fft::PlanKey.
+ *
+ * Caller buffers must have the same alignment as an fftw_malloc'd buffer when
+ * the stride is 1, which is the case for every dsp::PlanarSignal channel.
+ * Plans for strided (interleaved) buffers are created with FFTW_UNALIGNED.
  */
-template<typename _sample_t> requires std::convertible_to<_sample_t, double>
+template<typename _sample_t> requires dsp::fft::FFTWSample<_sample_t>
 class FFTConverter {
+private:
+	using __Traits = dsp::fft::FFTWTraits<_sample_t>;
+
 public:
+	using complex_type = typename __Traits::complex_type;
+
 	enum class AllocationStrategy : bool {
 		PATIENT,
 		IMPATIENT
 	};
 
+	enum class Normalization : bool {
+		/// Leave the output of the inverse transform scaled by the number of real samples, as fftw does
+		NONE,
+		/// Divide the output of the inverse transform by the number of real samples so that
+		/// inverse(forward(x)) == x
+		UNITARY
+	};
+
 private:
-	AllocationStrategy allocation_strategy ;
-	_sample_t*         left_samples_real = nullptr;
-	_sample_t*         right_samples_real = nullptr;
-	fftw_complex*      left_samples_complex = nullptr;
-	fftw_complex*      right_samples_complex = nullptr;
-	fftw_plan          left_real_to_complex_plan;
-	fftw_plan          left_complex_to_real_plan;
-	fftw_plan          right_real_to_complex_plan;
-	fftw_plan          right_complex_to_real_plan;
+	AllocationStrategy allocation_strategy;
+	const dsp::fft::Plan<_sample_t>* real_to_complex_plan = nullptr;
+	const dsp::fft::Plan<_sample_t>* complex_to_real_plan = nullptr;
 	size_t             num_real_samples = 0;
 	// Equivalent to num_real_samples / 2 + 1
 	size_t             num_complex_samples = 0;
+	// Distance, in samples, between consecutive real samples
+	size_t             stride = 1;
+	// Number of blocks transformed by each call
+	size_t             num_transforms = 1;
+	// Distance, in samples, between the first real samples of consecutive blocks
+	size_t             distance = 0;
 	// Whether the resources have been allocated
 	bool               are_resources_allocated = false;
 
 public:
 
-	FFTConverter(const AllocationStrategy allocation_strategy, const size_t num_real_samples, const bool alloc_immediately = false) :
+	/**
+	 * @param allocation_strategy How long fftw may spend finding the fastest plan
+	 * @param num_real_samples Number of real samples per transform
+	 * @param alloc_immediately Whether to create the plans in the constructor
+	 * @param stride Distance, in samples, between consecutive real samples. For example,
+	 * the stride of a channel of an interleaved stereo wave is 2
+	 * @param num_transforms Number of blocks transformed by each call
+	 * @param distance Distance, in samples, between the first real samples of consecutive blocks.
+	 * The spectra of consecutive blocks are always num_complex_samples apart
+	 */
+	FFTConverter(const AllocationStrategy allocation_strategy, const size_t num_real_samples,
+	             const bool alloc_immediately = false, const size_t stride = 1,
+	             const size_t num_transforms = 1, const size_t distance = 0) :
 			allocation_strategy(allocation_strategy),
 			num_real_samples(num_real_samples),
-			num_complex_samples(num_real_samples / 2 + 1) {
+			num_complex_samples(num_real_samples / 2 + 1),
+			stride(stride),
+			num_transforms(num_transforms),
+			distance(distance) {
 		if (alloc_immediately) {
 			this->allocate_resources();
 		}
 	}
 
+	/**
+	 * @brief  Converter that transforms every channel of interleaved frames at once
+	 * @param  num_real_samples Number of frames per transform
+	 * @param  num_channels Number of channels per frame
+	 */
+	static FFTConverter interleaved(const AllocationStrategy allocation_strategy, const size_t num_real_samples,
+	                                const size_t num_channels, const bool alloc_immediately = false) {
+		return FFTConverter(allocation_strategy, num_real_samples, alloc_immediately, num_channels, num_channels, 1);
+	}
+
+	/**
+	 * @brief  Converter that transforms consecutive, possibly overlapping, blocks of one channel at once.
+	 * Also usable for planar channels that are stored one after another by passing the channel length as the hop
+	 * @param  num_real_samples Number of samples per block
+	 * @param  num_blocks Number of blocks per transform
+	 * @param  hop_size Distance, in samples, between the starts of consecutive blocks
+	 */
+	static FFTConverter blocks(const AllocationStrategy allocation_strategy, const size_t num_real_samples,
+	                           const size_t num_blocks, const size_t hop_size, const bool alloc_immediately = false) {
+		return FFTConverter(allocation_strategy, num_real_samples, alloc_immediately, 1, num_blocks, hop_size);
+	}
+
 	// delete the copy constructors for now until they are needed
 	FFTConverter(const FFTConverter& rhs) = delete;
 	FFTConverter& operator=(const FFTConverter& rhs) = delete;
 
-	~FFTConverter() {
-		if (this->are_resources_allocated) {
-			delete[] this->left_samples_real;
-			delete[] this->right_samples_real;
-			fftw_free(this->left_samples_complex);
-			fftw_free(this->right_samples_complex);
-			fftw_destroy_plan(this->left_real_to_complex_plan);
-			fftw_destroy_plan(this->left_complex_to_real_plan);
-			fftw_destroy_plan(this->right_real_to_complex_plan);
-			fftw_destroy_plan(this->right_complex_to_real_plan);
-		}
-	}
-
 	/**
-	 * @brief  Allocate the resources necessary for the FFT conversion
-	 * @note   This may take several seconds, so it is a good idea to allocate the resources at program startup
+	 * @brief  Acquire the plans necessary for the FFT conversion from the plan registry
+	 * @note   Creating a plan may take several seconds, so it is a good idea to allocate the resources at program startup,
+	 *         or to cache the plans ahead of time with dsp::fft::preplan and load them with dsp::fft::import_wisdom.
+	 *         Plans that another converter has already created are reused without planning
 	 * @return True if resources were allocated at the time of this call, false if they were previously allocated
 	 */
 	bool allocate_resources() {
@@ -90,23 +134,83 @@ public:
 		}
 
 		this->are_resources_allocated = true;
-		uint32_t plan_flags = (this->allocation_strategy == AllocationStrategy::PATIENT) ? FFTW_PATIENT : 0;
-
-		this->left_samples_real = new _sample_t[this->num_real_samples];
-		this->right_samples_real = new _sample_t[this->num_real_samples];
-		this->left_samples_complex = fftw_alloc_complex(this->num_complex_samples);
-		this->right_samples_complex = fftw_alloc_complex(this->num_complex_samples);
-		this->left_real_to_complex_plan = fftw_plan_dft_r2c_1d(this->num_real_samples, this->left_samples_real,
-		                                                       this->left_samples_complex, plan_flags);
-		this->right_real_to_complex_plan = fftw_plan_dft_r2c_1d(this->num_real_samples, this->right_samples_real,
-		                                                        this->right_samples_complex, plan_flags);
-		this->left_complex_to_real_plan = fftw_plan_dft_c2r_1d(this->num_complex_samples, this->left_samples_complex,
-		                                                       this->left_samples_real, plan_flags);
-		this->right_complex_to_real_plan = fftw_plan_dft_c2r_1d(this->num_complex_samples, this->right_samples_complex,
-		                                                        this->right_samples_real, plan_flags);
+		const uint32_t plan_flags = (this->allocation_strategy == AllocationStrategy::PATIENT) ? FFTW_PATIENT : 0;
+		dsp::fft::PlanRegistry<_sample_t>& registry = dsp::fft::PlanRegistry<_sample_t>::instance();
+
+		this->real_to_complex_plan = registry.acquire(this->plan_key(dsp::fft::Direction::REAL_TO_COMPLEX), plan_flags);
+		this->complex_to_real_plan = registry.acquire(this->plan_key(dsp::fft::Direction::COMPLEX_TO_REAL), plan_flags);
 
 		return true;
 	}
 
-	r2c()
+	size_t get_num_real_samples() const {
+		return this->num_real_samples;
+	}
+
+	size_t get_num_complex_samples() const {
+		return this->num_complex_samples;
+	}
+
+	size_t get_num_transforms() const {
+		return this->num_transforms;
+	}
+
+	/**
+	 * @return Layout of the transforms of the given direction
+	 */
+	dsp::fft::PlanKey plan_key(const dsp::fft::Direction direction) const {
+		return { this->num_real_samples, this->stride, direction, this->num_transforms,
+		         (this->num_transforms == 1) ? 0 : this->distance };
+	}
+
+	/**
+	 * @brief Compute the spectrum of every block of real samples
+	 * @param real_samples num_transforms blocks of num_real_samples samples, stride samples apart. Not modified
+	 * @param complex_samples Destination of the num_transforms * num_complex_samples complex samples
+	 */
+	void forward(const _sample_t* const real_samples, complex_type* const complex_samples) const {
+		assert(this->real_to_complex_plan != nullptr);
+
+		this->real_to_complex_plan->execute(real_samples, complex_samples);
+	}
+
+	void forward(const std::span<const _sample_t> real_samples, const std::span<complex_type> complex_samples) const {
+		assert(real_samples.size() >= this->plan_key(dsp::fft::Direction::REAL_TO_COMPLEX).real_extent());
+		assert(complex_samples.size() >= this->num_transforms * this->num_complex_samples);
+
+		this->forward(real_samples.data(), complex_samples.data());
+	}
+
+	/**
+	 * @brief Compute every block of real samples from its spectrum. The blocks must not overlap
+	 * @param complex_samples num_transforms * num_complex_samples complex samples. Overwritten by the transform
+	 * @param real_samples Destination of the num_transforms blocks of num_real_samples samples, stride samples apart
+	 * @param normalization Whether to scale the output by 1 / num_real_samples
+	 */
+	void inverse(complex_type* const complex_samples, _sample_t* const real_samples,
+	             const Normalization normalization = Normalization::UNITARY) const {
+		assert(this->complex_to_real_plan != nullptr);
+
+		this->complex_to_real_plan->execute(complex_samples, real_samples);
+
+		if (normalization == Normalization::UNITARY) {
+			const _sample_t scale = _sample_t(1) / static_cast<_sample_t>(this->num_real_samples);
+
+			for (size_t t = 0; t < this->num_transforms; t++) {
+				_sample_t* const block = real_samples + t * this->distance;
+
+				for (size_t i = 0; i < this->num_real_samples; i++) {
+					block[i * this->stride] *= scale;
+				}
+			}
+		}
+	}
+
+	void inverse(const std::span<complex_type> complex_samples, const std::span<_sample_t> real_samples,
+	             const Normalization normalization = Normalization::UNITARY) const {
+		assert(complex_samples.size() >= this->num_transforms * this->num_complex_samples);
+		assert(real_samples.size() >= this->plan_key(dsp::fft::Direction::COMPLEX_TO_REAL).real_extent());
+
+		this->inverse(complex_samples.data(), real_samples.data(), normalization);
+	}
 };
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+
+#include "fftw_traits.hpp"
+#include "fft_wisdom.hpp"
+#include "tracing.hpp"
+
+namespace dsp::fft {
+enum class Direction : uint8_t {
+	REAL_TO_COMPLEX,
+	COMPLEX_TO_REAL
+};
+
+/**
+ * @brief Describes a batch of 1-D real transforms that are executed by a single
+ * plan. Transforms with equal keys may share a plan.
+ *
+ * The real samples of transform i, sample j are at i * distance + j * stride.
+ * The complex samples of the transforms are always stored one after another,
+ * size / 2 + 1 apart. Common layouts of num_channels channels are
+ * - interleaved frames: stride = num_channels, distance = 1, num_transforms = num_channels
+ * - planar channels in one buffer: stride = 1, distance = channel length, num_transforms = num_channels
+ * - consecutive blocks of one channel: stride = 1, distance = hop size, num_transforms = number of blocks
+ */
+struct PlanKey {
+	/// Number of real samples per transform
+	size_t    size           = 0;
+	/// Distance, in samples, between consecutive real samples
+	size_t    stride         = 1;
+	Direction direction      = Direction::REAL_TO_COMPLEX;
+	/// Number of transforms executed at once
+	size_t    num_transforms = 1;
+	/// Distance, in samples, between the first real samples of consecutive transforms.
+	/// Unused when num_transforms is 1
+	size_t    distance       = 0;
+
+	constexpr bool operator==(const PlanKey& rhs) const = default;
+
+	/**
+	 * @return Number of complex samples per transform
+	 */
+	constexpr size_t complex_size() const {
+		return this->size / 2 + 1;
+	}
+
+	/**
+	 * @return Minimum number of samples of a real buffer that the transforms may be executed on
+	 */
+	constexpr size_t real_extent() const {
+		return (this->num_transforms - 1) * this->distance + (this->size - 1) * this->stride + 1;
+	}
+
+	/**
+	 * @return Minimum number of samples of a complex buffer that the transforms may be executed on
+	 */
+	constexpr size_t complex_extent() const {
+		return this->num_transforms * this->complex_size();
+	}
+};
+
+/**
+ * @brief Immutable fftw plan. Executing a plan through fftw's new-array execute
+ * functions is thread-safe, so one plan may be executed concurrently from any
+ * number of threads as long as each thread passes its own buffers.
+ */
+template<typename _sample_t> requires FFTWSample<_sample_t>
+class Plan {
+private:
+	using __Traits = FFTWTraits<_sample_t>;
+
+public:
+	using complex_type = typename __Traits::complex_type;
+
+private:
+	typename __Traits::plan_type plan = nullptr;
+	PlanKey                      key;
+
+	template<typename __sample_t> requires FFTWSample<__sample_t>
+	friend class PlanRegistry;
+
+public:
+	Plan() = default;
+
+	Plan(const Plan& rhs) = delete;
+	Plan& operator=(const Plan& rhs) = delete;
+
+	~Plan() {
+		if (this->plan != nullptr) {
+			__Traits::destroy_plan(this->plan);
+		}
+	}
+
+	const PlanKey& get_key() const {
+		return this->key;
+	}
+
+	/**
+	 * @brief Execute a REAL_TO_COMPLEX plan
+	 * @param real_samples key.real_extent() samples in the layout described by the key. Not modified
+	 * @param complex_samples Destination of the key.complex_extent() complex samples
+	 */
+	void execute(const _sample_t* const real_samples, complex_type* const complex_samples) const {
+		STAC_TRACE_SCOPE("fft_forward", this->key.size);
+		// r2c plans do not modify their input, fftw just does not declare it as const
+		__Traits::execute_dft_r2c(this->plan, const_cast<_sample_t*>(real_samples),
+		                          reinterpret_cast<typename __Traits::fftw_complex_type*>(complex_samples));
+	}
+
+	/**
+	 * @brief Execute a COMPLEX_TO_REAL plan. The output is not normalized
+	 * @param complex_samples key.complex_extent() complex samples. Overwritten by the transform
+	 * @param real_samples Destination of the real samples in the layout described by the key
+	 */
+	void execute(complex_type* const complex_samples, _sample_t* const real_samples) const {
+		STAC_TRACE_SCOPE("fft_inverse", this->key.size);
+		__Traits::execute_dft_c2r(this->plan, reinterpret_cast<typename __Traits::fftw_complex_type*>(complex_samples),
+		                          real_samples);
+	}
+};
+
+/**
+ * @brief Process-wide set of fftw plans of one precision, shared by every
+ * FFTConverter and thread.
+ *
+ * Plans are created by acquire, which plans under the fftw planner mutex and
+ * must therefore be called off the audio thread, e.g. at startup. Created plans
+ * are never destroyed before the process exits, so find is a lock-free lookup
+ * that the audio thread may use, and the returned pointers are always valid.
+ *
+ * Caller buffers must have the same alignment as an fftw_malloc'd buffer when
+ * the stride is 1. Plans for strided buffers are created with FFTW_UNALIGNED.
+ */
+template<typename _sample_t> requires FFTWSample<_sample_t>
+class PlanRegistry {
+public:
+	/// Maximum number of distinct plans that may be created
+	static constexpr size_t MAX_PLANS = 256;
+
+private:
+	using __Traits = FFTWTraits<_sample_t>;
+
+	std::array<Plan<_sample_t>, MAX_PLANS> plans;
+	/// Number of plans in plans that have been completely created
+	std::atomic<size_t>                    num_plans = 0;
+
+	PlanRegistry() = default;
+
+public:
+	PlanRegistry(const PlanRegistry& rhs) = delete;
+	PlanRegistry& operator=(const PlanRegistry& rhs) = delete;
+
+	static PlanRegistry& instance() {
+		static PlanRegistry registry;
+
+		return registry;
+	}
+
+	/**
+	 * @brief  Real-time safe. Look up a plan that has already been created
+	 * @param  key Transform to look up
+	 * @return Plan for the transform, or nullptr if it has not been acquired yet
+	 */
+	const Plan<_sample_t>* find(const PlanKey& key) const noexcept {
+		const size_t num_plans = this->num_plans.load(std::memory_order_acquire);
+
+		for (size_t i = 0; i < num_plans; i++) {
+			if (this->plans[i].key == key) {
+				return &this->plans[i];
+			}
+		}
+
+		return nullptr;
+	}
+
+	/**
+	 * @brief  Not real-time safe. Get the plan for a transform, creating it if it does
+	 * not exist. A plan that already exists is returned regardless of plan_flags.
+	 * @param  key Transform to get the plan of
+	 * @param  plan_flags fftw planner flags used if the plan is created
+	 * @return Plan for the transform, or nullptr if fftw could not create it or the registry is full
+	 */
+	const Plan<_sample_t>* acquire(const PlanKey& key, const unsigned plan_flags = FFTW_MEASURE) {
+		std::lock_guard<std::mutex> lock(planner_mutex());
+
+		if (const Plan<_sample_t>* const plan = this->find(key); plan != nullptr) {
+			return plan;
+		}
+
+		const size_t index = this->num_plans.load(std::memory_order_relaxed);
+
+		if (index >= MAX_PLANS || key.size == 0 || key.stride == 0 || key.num_transforms == 0) {
+			return nullptr;
+		}
+
+		const unsigned flags = (key.stride == 1) ? plan_flags : (plan_flags | FFTW_UNALIGNED);
+		const int n = static_cast<int>(key.size);
+		const int howmany = static_cast<int>(key.num_transforms);
+		const int real_stride = static_cast<int>(key.stride);
+		const int real_distance = static_cast<int>(key.distance);
+		const int complex_distance = static_cast<int>(key.complex_size());
+		// planning overwrites its buffers, so plan on scratch buffers
+		_sample_t* const real_scratch = __Traits::alloc_real(key.real_extent());
+		typename __Traits::fftw_complex_type* const complex_scratch = __Traits::alloc_complex(key.complex_extent());
+		Plan<_sample_t>& plan = this->plans[index];
+
+		if (key.direction == Direction::REAL_TO_COMPLEX) {
+			plan.plan = __Traits::plan_many_dft_r2c(1, &n, howmany, real_scratch, nullptr, real_stride, real_distance,
+			                                        complex_scratch, nullptr, 1, complex_distance, flags);
+		} else {
+			plan.plan = __Traits::plan_many_dft_c2r(1, &n, howmany, complex_scratch, nullptr, 1, complex_distance,
+			                                        real_scratch, nullptr, real_stride, real_distance, flags);
+		}
+
+		plan.key = key;
+
+		__Traits::free(real_scratch);
+		__Traits::free(complex_scratch);
+
+		if (plan.plan == nullptr) {
+			return nullptr;
+		}
+
+		// publish the plan to find only once it has been completely created
+		this->num_plans.store(index + 1, std::memory_order_release);
+
+		return &plan;
+	}
+
+	/**
+	 * @return Number of plans that have been created
+	 */
+	size_t size() const noexcept {
+		return this->num_plans.load(std::memory_order_acquire);
+	}
+};
+} // namespace dsp::fft
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <span>
+#include <filesystem>
+#include <initializer_list>
+#include <system_error>
+#include <cstddef>
+
+#include "fftw_traits.hpp"
+
+namespace dsp::fft {
+/**
+ * @brief  The fftw planner, wisdom, and plan destruction are not thread-safe,
+ * so every call into them must hold this mutex. Executing a plan does not need it.
+ * @return Process-wide fftw planner mutex
+ */
+std::mutex& planner_mutex();
+
+/**
+ * @brief  Identify the CPU so that wisdom measured on one machine is not used on another
+ * @return CPU brand string, reduced to characters that are safe to use in a file name
+ */
+std::string cpu_identifier();
+
+/**
+ * @brief  Directory that wisdom is cached in. Taken from the STAC_AUDIO_WISDOM_DIR
+ * environment variable, falling back to the user's cache directory
+ * @return Wisdom cache directory
+ */
+std::filesystem::path default_wisdom_directory();
+
+/**
+ * @brief  Path of the wisdom file for _sample_t precision on this CPU. fftw keys
+ * the wisdom inside the file by transform size and layout.
+ * @param  directory Directory containing the wisdom files
+ * @return Wisdom file path
+ */
+template<typename _sample_t> requires FFTWSample<_sample_t>
+std::filesystem::path wisdom_file_path(const std::filesystem::path& directory = default_wisdom_directory()) {
+	return directory / ("fftw_" + std::string(FFTWTraits<_sample_t>::PRECISION_NAME) + "_" + cpu_identifier() + ".wisdom");
+}
+
+/**
+ * @brief  Load cached wisdom for _sample_t precision. Plans created afterwards
+ * with the same size, layout, and flags as cached wisdom are created in milliseconds.
+ * @param  directory Directory containing the wisdom files
+ * @return Whether wisdom was cached and could be imported
+ */
+template<typename _sample_t> requires FFTWSample<_sample_t>
+bool import_wisdom(const std::filesystem::path& directory = default_wisdom_directory()) {
+	const std::filesystem::path file_path = wisdom_file_path<_sample_t>(directory);
+	std::lock_guard<std::mutex> lock(planner_mutex());
+
+	return FFTWTraits<_sample_t>::import_wisdom_from_filename(file_path.string().c_str()) != 0;
+}
+
+/**
+ * @brief  Save all of the wisdom accumulated for _sample_t precision, including
+ * any wisdom that was previously imported
+ * @param  directory Directory containing the wisdom files. Created if it does not exist
+ * @return Whether the wisdom could be written
+ */
+template<typename _sample_t> requires FFTWSample<_sample_t>
+bool export_wisdom(const std::filesystem::path& directory = default_wisdom_directory()) {
+	std::error_code err;
+	std::filesystem::create_directories(directory, err);
+
+	const std::filesystem::path file_path = wisdom_file_path<_sample_t>(directory);
+	// write to a temporary file first so that a concurrent import never reads a partial file
+	std::filesystem::path tmp_path = file_path;
+	tmp_path += ".tmp";
+
+	std::lock_guard<std::mutex> lock(planner_mutex());
+
+	if (FFTWTraits<_sample_t>::export_wisdom_to_filename(tmp_path.string().c_str()) == 0) {
+		return false;
+	}
+
+	std::filesystem::rename(tmp_path, file_path, err);
+
+	return !err;
+}
+
+/**
+ * @brief  Plan the real transforms of the given sizes with the given flags and
+ * cache the resulting wisdom, e.g. at install time, so that later processes can
+ * create plans of these sizes without measuring
+ * @param  sizes Numbers of real samples per transform
+ * @param  strides Distances between consecutive real samples to plan for, e.g. 1 for
+ * planar buffers and 2 for a channel of an interleaved stereo buffer. Strides other
+ * than 1 are also planned as a batch of every channel of the interleaved buffer
+ * @param  plan_flags fftw planner flags, e.g. FFTW_PATIENT
+ * @param  directory Directory containing the wisdom files
+ * @return Whether the wisdom could be written
+ */
+template<typename _sample_t> requires FFTWSample<_sample_t>
+bool preplan(const std::span<const size_t> sizes, const std::span<const size_t> strides, const unsigned plan_flags,
+             const std::filesystem::path& directory = default_wisdom_directory()) {
+	using __Traits = FFTWTraits<_sample_t>;
+
+	import_wisdom<_sample_t>(directory);
+
+	{
+		std::lock_guard<std::mutex> lock(planner_mutex());
+
+		const auto plan_layout = [plan_flags](const size_t size, const size_t stride, const size_t howmany,
+		                                      const size_t distance) {
+			const int n = static_cast<int>(size);
+			const int real_stride = static_cast<int>(stride);
+			const int real_distance = static_cast<int>(distance);
+			const int complex_distance = static_cast<int>(size / 2 + 1);
+			const int num_transforms = static_cast<int>(howmany);
+			const unsigned flags = (stride == 1) ? plan_flags : (plan_flags | FFTW_UNALIGNED);
+			_sample_t* const real_scratch = __Traits::alloc_real((howmany - 1) * distance + (size - 1) * stride + 1);
+			typename __Traits::fftw_complex_type* const complex_scratch = __Traits::alloc_complex(howmany * (size / 2 + 1));
+
+			__Traits::destroy_plan(__Traits::plan_many_dft_r2c(1, &n, num_transforms, real_scratch, nullptr, real_stride,
+			                                                   real_distance, complex_scratch, nullptr, 1, complex_distance, flags));
+			__Traits::destroy_plan(__Traits::plan_many_dft_c2r(1, &n, num_transforms, complex_scratch, nullptr, 1,
+			                                                   complex_distance, real_scratch, nullptr, real_stride, real_distance, flags));
+
+			__Traits::free(real_scratch);
+			__Traits::free(complex_scratch);
+		};
+
+		for (const size_t size : sizes) {
+			for (const size_t stride : strides) {
+				// a single channel of an interleaved buffer
+				plan_layout(size, stride, 1, 0);
+
+				if (stride != 1) {
+					// every channel of an interleaved buffer at once, as FFTConverter::interleaved does
+					plan_layout(size, stride, stride, 1);
+				}
+			}
+		}
+	}
+
+	return export_wisdom<_sample_t>(directory);
+}
+
+template<typename _sample_t> requires FFTWSample<_sample_t>
+bool preplan(const std::initializer_list<size_t> sizes, const unsigned plan_flags = FFTW_PATIENT,
+             const std::filesystem::path& directory = default_wisdom_directory()) {
+	static constexpr size_t PLANAR_STRIDE[] = { 1 };
+
+	return preplan<_sample_t>(std::span<const size_t>(sizes.begin(), sizes.size()), PLANAR_STRIDE, plan_flags, directory);
+}
+} // namespace dsp::fft
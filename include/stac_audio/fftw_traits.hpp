@@ -0,0 +1,67 @@
+#pragma once
+
+#include <fftw3.h>
+#include <complex>
+#include <type_traits>
+
+namespace dsp::fft {
+/**
+ * @brief Maps a sample type to the fftw API of the same precision, so that
+ * float samples go through fftwf_* and double samples through fftw_* without
+ * any conversion
+ */
+template<typename _sample_t>
+struct FFTWTraits;
+
+template<>
+struct FFTWTraits<float> {
+	using real_type         = float;
+	using fftw_complex_type = fftwf_complex;
+	using complex_type      = std::complex<float>;
+	using plan_type         = fftwf_plan;
+
+	/// Short name of the precision, used to key cached wisdom
+	static constexpr char PRECISION_NAME[] = "f32";
+
+	static constexpr auto plan_many_dft_r2c            = &fftwf_plan_many_dft_r2c;
+	static constexpr auto plan_many_dft_c2r            = &fftwf_plan_many_dft_c2r;
+	static constexpr auto execute_dft_r2c              = &fftwf_execute_dft_r2c;
+	static constexpr auto execute_dft_c2r              = &fftwf_execute_dft_c2r;
+	static constexpr auto destroy_plan                 = &fftwf_destroy_plan;
+	static constexpr auto alloc_real                   = &fftwf_alloc_real;
+	static constexpr auto alloc_complex                = &fftwf_alloc_complex;
+	static constexpr auto free                         = &fftwf_free;
+	static constexpr auto alignment_of                 = &fftwf_alignment_of;
+	static constexpr auto import_wisdom_from_filename  = &fftwf_import_wisdom_from_filename;
+	static constexpr auto export_wisdom_to_filename    = &fftwf_export_wisdom_to_filename;
+};
+
+template<>
+struct FFTWTraits<double> {
+	using real_type         = double;
+	using fftw_complex_type = fftw_complex;
+	using complex_type      = std::complex<double>;
+	using plan_type         = fftw_plan;
+
+	/// Short name of the precision, used to key cached wisdom
+	static constexpr char PRECISION_NAME[] = "f64";
+
+	static constexpr auto plan_many_dft_r2c            = &fftw_plan_many_dft_r2c;
+	static constexpr auto plan_many_dft_c2r            = &fftw_plan_many_dft_c2r;
+	static constexpr auto execute_dft_r2c              = &fftw_execute_dft_r2c;
+	static constexpr auto execute_dft_c2r              = &fftw_execute_dft_c2r;
+	static constexpr auto destroy_plan                 = &fftw_destroy_plan;
+	static constexpr auto alloc_real                   = &fftw_alloc_real;
+	static constexpr auto alloc_complex                = &fftw_alloc_complex;
+	static constexpr auto free                         = &fftw_free;
+	static constexpr auto alignment_of                 = &fftw_alignment_of;
+	static constexpr auto import_wisdom_from_filename  = &fftw_import_wisdom_from_filename;
+	static constexpr auto export_wisdom_to_filename    = &fftw_export_wisdom_to_filename;
+};
+
+/**
+ * @brief Sample types that have an fftw API of the same precision
+ */
+template<typename _sample_t>
+concept FFTWSample = std::is_same_v<_sample_t, float> || std::is_same_v<_sample_t, double>;
+} // namespace dsp::fft
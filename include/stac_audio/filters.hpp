@@ -1,10 +1,8 @@
 #pragma once
 
 /*
- * I should probably split up the left and right
- * audio channels into separate arrays for ease of use
- * with the fftw libraries as well as being able to easily
- * retrieve the samples of only a particular channel
+ * Filters should operate on the per-channel buffers of a dsp::PlanarSignal
+ * so that they read memory sequentially, the same as fftw
  */
 class Filter {
 private:
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <span>
+#include <cstddef>
+
+#include "dsp_declarations.hpp"
+#include "signals.hpp"
+#include "smoothed_value.hpp"
+
+namespace dsp {
+/**
+ * @brief Gain stage whose changes are ramped by a dsp::SmoothedValue
+ */
+template<typename _sample_t, size_t _num_channels = NUM_CHANNELS>
+class Gain {
+public:
+	using frame_type = Frame<_sample_t, _num_channels>;
+
+private:
+	SmoothedValue<_sample_t> gain;
+
+public:
+	explicit Gain(const _sample_t gain = _sample_t(1), const size_t ramp_length = SmoothedValue<_sample_t>::DEFAULT_RAMP_LENGTH) :
+		gain(gain, ramp_length)
+	{ }
+
+	/**
+	 * @brief Ramp to a new linear gain
+	 */
+	void set_gain(const _sample_t gain) {
+		this->gain.set_target(gain);
+	}
+
+	_sample_t get_gain() const {
+		return this->gain.get_target();
+	}
+
+	void process_frame(frame_type& frame) {
+		const _sample_t value = this->gain.next();
+
+		for (size_t c = 0; c < _num_channels; c++) {
+			frame[c] *= value;
+		}
+	}
+
+	void process(const std::span<frame_type> frames) {
+		this->gain.apply(frames);
+	}
+
+	/**
+	 * @brief Finish any ramp immediately
+	 */
+	void reset() {
+		this->gain.set_immediate(this->gain.get_target());
+	}
+};
+} // namespace dsp
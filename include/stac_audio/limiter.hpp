@@ -0,0 +1,81 @@
+#pragma once
+
+#include <span>
+#include <cmath>
+#include <algorithm>
+#include <cstddef>
+
+#include "dsp_declarations.hpp"
+#include "signals.hpp"
+
+namespace dsp {
+/**
+ * @brief Peak limiter without lookahead. The envelope rises instantly to the peak
+ * of each frame, so no sample ever exceeds the threshold, and falls back
+ * exponentially over the release time. Every channel of a frame is reduced by the
+ * same amount so that the stereo image does not shift.
+ */
+template<typename _sample_t, size_t _num_channels = NUM_CHANNELS>
+class Limiter {
+public:
+	using frame_type = Frame<_sample_t, _num_channels>;
+
+	static constexpr time_ms_t DEFAULT_RELEASE_MS = 50;
+
+private:
+	_sample_t threshold;
+	/// Fraction of the envelope kept each frame while it is released
+	_sample_t release_coefficient;
+	_sample_t envelope = _sample_t(0);
+
+public:
+	/**
+	 * @param threshold Linear amplitude that the output may not exceed
+	 * @param sample_rate Sample rate of the limited signal
+	 * @param release_ms Time for the envelope to fall by about 63%
+	 */
+	explicit Limiter(const _sample_t threshold = _sample_t(1), const sample_rate_t sample_rate = SAMPLE_RATE,
+	                 const time_ms_t release_ms = DEFAULT_RELEASE_MS) :
+			threshold(threshold) {
+		this->set_release(sample_rate, release_ms);
+	}
+
+	void set_threshold(const _sample_t threshold) {
+		this->threshold = threshold;
+	}
+
+	void set_release(const sample_rate_t sample_rate, const time_ms_t release_ms) {
+		const double release_frames = static_cast<double>(release_ms) * static_cast<double>(sample_rate) / 1000.0;
+
+		this->release_coefficient = (release_frames > 0.0) ? static_cast<_sample_t>(std::exp(-1.0 / release_frames)) : _sample_t(0);
+	}
+
+	void process_frame(frame_type& frame) {
+		_sample_t peak = _sample_t(0);
+
+		for (size_t c = 0; c < _num_channels; c++) {
+			peak = std::max(peak, std::abs(frame[c]));
+		}
+
+		this->envelope = std::max(peak, this->envelope * this->release_coefficient);
+
+		if (this->envelope > this->threshold) {
+			const _sample_t gain = this->threshold / this->envelope;
+
+			for (size_t c = 0; c < _num_channels; c++) {
+				frame[c] *= gain;
+			}
+		}
+	}
+
+	void process(const std::span<frame_type> frames) {
+		for (frame_type& frame : frames) {
+			this->process_frame(frame);
+		}
+	}
+
+	void reset() {
+		this->envelope = _sample_t(0);
+	}
+};
+} // namespace dsp
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+#include "signals.hpp"
+
+/**
+ * @brief Read-only memory mapping of an uncompressed WAV file whose samples are
+ * already in the dsp::sample_t format (32-bit IEEE float). The samples are
+ * exposed in place as a dsp::SignalView without being decoded or copied, and
+ * the mapped pages are shared through the OS page cache with every other
+ * process that maps the same file.
+ */
+class MappedAudioFile {
+private:
+	const std::byte*                 data        = nullptr;
+	size_t                           data_size   = 0;
+#ifdef _WIN32
+	void*                            file_handle    = nullptr;
+	void*                            mapping_handle = nullptr;
+#endif
+	dsp::SignalView<dsp::sample_t>   view;
+
+public:
+	MappedAudioFile() = default;
+
+	MappedAudioFile(const MappedAudioFile& rhs) = delete;
+	MappedAudioFile& operator=(const MappedAudioFile& rhs) = delete;
+
+	MappedAudioFile(MappedAudioFile&& rhs) noexcept;
+	MappedAudioFile& operator=(MappedAudioFile&& rhs) noexcept;
+
+	~MappedAudioFile();
+
+	/**
+	 * @brief  Map a file and validate its header
+	 * @param  file_path Path of the WAV file to map
+	 * @return Whether the file could be mapped and contains 32-bit float samples.
+	 * If false, the file must be decoded through libsndfile instead.
+	 */
+	bool open(const std::string& file_path);
+	void close();
+
+	bool is_open() const;
+
+	/**
+	 * @return View of the interleaved samples of the file. Valid until the file is closed
+	 */
+	const dsp::SignalView<dsp::sample_t>& get_view() const;
+
+private:
+	bool map(const std::string& file_path);
+	void unmap();
+	/**
+	 * @brief  Parse the RIFF/WAVE header of the mapped file and point the view at the sample data
+	 * @return Whether the header describes samples that may be viewed in place
+	 */
+	bool parse_header();
+};
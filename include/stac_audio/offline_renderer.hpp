@@ -0,0 +1,128 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <sndfile.h>
+
+#include "dsp_declarations.hpp"
+#include "signals.hpp"
+#include "smoothed_value.hpp"
+#include "effect_chain.hpp"
+
+/**
+ * @brief Configuration of an OfflineRenderer
+ */
+struct OfflineRenderConfig {
+	/// Frames processed per block. Larger blocks amortize the per-block cost of the effects
+	size_t  block_frames = 16384;
+	/// libsndfile format of rendered files (major format | subtype)
+	int32_t format       = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+	/// Number of channels of rendered files. 0 uses the channel count of the source,
+	/// up to dsp::NUM_CHANNELS
+	size_t  num_channels = 0;
+};
+
+/**
+ * @brief Renders a signal or a sound file through an effect chain and a gain as
+ * fast as the CPU allows, without an audio device. The blocks take the same path
+ * as they do in the audio callback of an AudioEngine, so an offline render sounds
+ * the same as playback and is deterministic.
+ *
+ * The effects are shared with any other chain they were added to, so a renderer
+ * should be given its own effects rather than those of a running engine.
+ */
+class OfflineRenderer {
+public:
+	using Config = OfflineRenderConfig;
+
+	/// Effects applied to every block, in order
+	EffectChain<dsp::sample_t>              effects;
+	/// Gain applied after the effects
+	dsp::SmoothedValue<dsp::amplitude_t>    gain = dsp::SmoothedValue<dsp::amplitude_t>(1.0);
+
+private:
+	Config                                  config;
+	std::vector<dsp::Frame<dsp::sample_t>>  block;
+	/// Interleaved samples read from or written to a sound file
+	std::vector<dsp::sample_t>              file_buffer;
+	size_t                                  num_frames_rendered = 0;
+
+public:
+	explicit OfflineRenderer(const Config& config = Config());
+
+	/**
+	 * @brief  Render a signal into another signal
+	 * @param  input Signal to render
+	 * @param  output Rendered signal, resized to the length of the input
+	 * @return Whether the signal was rendered
+	 */
+	bool render(const dsp::PlanarSignal<dsp::sample_t>& input, dsp::PlanarSignal<dsp::sample_t>& output);
+	/**
+	 * @brief  Render a signal into a sound file
+	 * @param  input Signal to render
+	 * @param  output_path Path of the sound file to write
+	 * @return Whether the file was written
+	 */
+	bool render(const dsp::PlanarSignal<dsp::sample_t>& input, const std::string& output_path);
+	/**
+	 * @brief  Render interleaved samples viewed in place, e.g. of a memory mapped
+	 * AudioFile, into a signal without copying the input first
+	 * @param  input Samples to render
+	 * @param  output Rendered signal, resized to the length of the input
+	 * @return Whether the samples were rendered
+	 */
+	bool render(const dsp::SignalView<dsp::sample_t>& input, dsp::PlanarSignal<dsp::sample_t>& output);
+	/**
+	 * @brief  Render interleaved samples viewed in place into a sound file
+	 * @param  input Samples to render
+	 * @param  output_path Path of the sound file to write
+	 * @return Whether the file was written
+	 */
+	bool render(const dsp::SignalView<dsp::sample_t>& input, const std::string& output_path);
+	/**
+	 * @brief  Render a sound file into another sound file, block by block, so memory
+	 * use does not depend on the length of the file
+	 * @param  input_path Path of the sound file to render
+	 * @param  output_path Path of the sound file to write
+	 * @return Whether the input was read and the output written
+	 */
+	bool render(const std::string& input_path, const std::string& output_path);
+
+	/**
+	 * @brief Clear the state of the effects, e.g. before rendering an unrelated file
+	 */
+	void reset();
+
+	const Config& get_config() const;
+	/**
+	 * @return Number of frames written by the last render
+	 */
+	size_t get_num_frames_rendered() const;
+	/**
+	 * @return Number of channels rendered for a source of source_channels channels
+	 */
+	size_t output_channels(const size_t source_channels) const;
+
+private:
+	/**
+	 * @brief Render num_frames frames of a PlanarSignal or a SignalView into a signal
+	 */
+	template<typename _input_t>
+	bool render_to_signal(const _input_t& input, const dsp::sample_rate_t sample_rate, const size_t num_frames,
+	                      const size_t num_channels, dsp::PlanarSignal<dsp::sample_t>& output);
+	/**
+	 * @brief Render num_frames frames of a PlanarSignal or a SignalView into a sound file
+	 */
+	template<typename _input_t>
+	bool render_to_file(const _input_t& input, const dsp::sample_rate_t sample_rate, const size_t num_frames,
+	                    const size_t num_channels, const std::string& output_path);
+	/**
+	 * @brief Apply the effects and the gain to the first num_frames frames of the
+	 * block and interleave them into the file buffer
+	 */
+	void process_block(const size_t num_frames, const size_t out_channels);
+	bool write_file(SNDFILE* sf, const size_t num_frames);
+	SNDFILE* open_output(const std::string& output_path, const dsp::sample_rate_t sample_rate,
+	                     const size_t num_channels) const;
+};
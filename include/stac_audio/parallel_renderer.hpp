@@ -0,0 +1,74 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "dsp_declarations.hpp"
+#include "signals.hpp"
+#include "offline_renderer.hpp"
+#include "thread_pool.hpp"
+
+/**
+ * @brief Configuration of a ParallelRenderer
+ */
+struct ParallelRenderConfig {
+	/// Number of worker threads. 0 uses one per hardware thread
+	size_t              num_threads    = 0;
+	/// Frames of a signal rendered by one job
+	size_t              chunk_frames   = 1 << 18;
+	/// Frames before a chunk that are rendered and discarded to settle the state of
+	/// stateful effects, e.g. the tail of an IIR filter or the overlap of an STFT
+	size_t              warm_up_frames = 1 << 13;
+	/// Configuration of the renderer of every job
+	OfflineRenderConfig render;
+};
+
+/**
+ * @brief Renders batches of files, or long signals split into chunks, on a
+ * work-stealing ThreadPool. Every job gets a fresh OfflineRenderer that is set up
+ * by the configure function, so jobs never share effect state. The output does not
+ * depend on the number of threads or on the order the jobs finish in.
+ */
+class ParallelRenderer {
+public:
+	using Config = ParallelRenderConfig;
+	/// Adds the effects and sets the gain of the renderer of a job. Called concurrently by the workers
+	using configure_type = std::function<void(OfflineRenderer&)>;
+
+	struct FileJob {
+		std::string input_path;
+		std::string output_path;
+	};
+
+private:
+	Config     config;
+	ThreadPool pool;
+
+public:
+	explicit ParallelRenderer(const Config& config = Config());
+
+	/**
+	 * @brief  Render every file on its own worker
+	 * @param  jobs Files to render
+	 * @param  configure Sets up the renderer of each file
+	 * @return Whether each file was rendered, in the order of the jobs
+	 */
+	std::vector<bool> render_files(const std::vector<FileJob>& jobs, const configure_type& configure);
+
+	/**
+	 * @brief  Render a signal in chunks across the workers. Each chunk is preceded by
+	 * warm_up_frames frames of the input whose output is discarded, so that the
+	 * chunks join without clicks. Effects whose memory is longer than the warm-up,
+	 * e.g. a long reverb, will differ slightly from a sequential render at the joins.
+	 * @param  input Signal to render
+	 * @param  output Rendered signal, resized to the length of the input
+	 * @param  configure Sets up the renderer of each chunk
+	 * @return Whether every chunk was rendered
+	 */
+	bool render_chunked(const dsp::PlanarSignal<dsp::sample_t>& input, dsp::PlanarSignal<dsp::sample_t>& output,
+	                    const configure_type& configure);
+
+	const Config& get_config() const;
+	size_t num_threads() const;
+};
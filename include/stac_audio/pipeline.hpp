@@ -0,0 +1,100 @@
+#pragma once
+
+#include <tuple>
+#include <span>
+#include <type_traits>
+#include <concepts>
+#include <cstddef>
+
+#include "signals.hpp"
+
+namespace dsp {
+/**
+ * @brief Processing stage that may be fused into a Pipeline. It processes
+ * interleaved frames in place one at a time, and should be cheap enough to be
+ * inlined into the pipeline's loop.
+ */
+template<typename _stage_t>
+concept FrameStage = requires(_stage_t stage, typename _stage_t::frame_type& frame) {
+	typename _stage_t::frame_type;
+	{ stage.process_frame(frame) } -> std::same_as<void>;
+};
+
+/**
+ * @brief Fixed chain of stages, e.g. Biquad -> Equalizer -> Gain -> Limiter, that
+ * is fused at compile time into a single pass over the frames. Each frame goes
+ * through every stage before the next one is loaded, so the block is read and
+ * written once rather than once per stage, and there is no runtime dispatch.
+ *
+ * A Pipeline is itself a FrameStage and has process/reset, so pipelines may be
+ * nested and a pipeline may be used as one effect of an EffectChain through
+ * ProcessorEffect.
+ */
+template<FrameStage _first_t, FrameStage... _rest_t>
+class Pipeline {
+public:
+	using frame_type = typename _first_t::frame_type;
+
+	static_assert((std::is_same_v<frame_type, typename _rest_t::frame_type> && ...),
+	              "Every stage of a pipeline must process the same frame type");
+
+	static constexpr size_t num_stages = 1 + sizeof...(_rest_t);
+
+private:
+	std::tuple<_first_t, _rest_t...> stages;
+
+public:
+	Pipeline() = default;
+
+	explicit Pipeline(_first_t first, _rest_t... rest) :
+		stages(std::move(first), std::move(rest)...)
+	{ }
+
+	/**
+	 * @return Stage at _index, e.g. to change its parameters
+	 */
+	template<size_t _index>
+	auto& stage() {
+		return std::get<_index>(this->stages);
+	}
+
+	void process_frame(frame_type& frame) {
+		std::apply([&frame](auto&... stages) {
+			(stages.process_frame(frame), ...);
+		}, this->stages);
+	}
+
+	void process(const std::span<frame_type> frames) {
+		for (frame_type& frame : frames) {
+			this->process_frame(frame);
+		}
+	}
+
+	/**
+	 * @brief Process a wave whose capacity is known at compile time, which lets the
+	 * compiler unroll and schedule the fused loop for that exact length
+	 */
+	template<typename _sample_t, size_t _capacity, size_t _num_channels>
+	void process(Wave<_sample_t, _capacity, _num_channels>& wave) {
+		static_assert(std::is_same_v<typename Wave<_sample_t, _capacity, _num_channels>::frame_type, frame_type>,
+		              "The wave's frames must be the pipeline's frame type");
+
+		for (size_t i = 0; i < _capacity; i++) {
+			this->process_frame(wave[i]);
+		}
+	}
+
+	/**
+	 * @brief Reset every stage that has a reset method
+	 */
+	void reset() {
+		std::apply([](auto&... stages) {
+			([&stages]() {
+				if constexpr (requires { stages.reset(); }) {
+					stages.reset();
+				}
+			}(), ...);
+		}, this->stages);
+	}
+};
+} // namespace dsp
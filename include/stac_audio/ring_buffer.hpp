@@ -0,0 +1,158 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <span>
+#include <algorithm>
+#include <cstddef>
+
+#include "aligned_allocator.hpp"
+
+namespace dsp {
+/**
+ * @brief Lock-free single producer, single consumer ring buffer with a capacity
+ * that is fixed at construction. Neither side ever allocates or blocks, so the
+ * buffer may be used to move data to and from the real-time audio thread.
+ *
+ * The producer and consumer may access contiguous regions of the buffer in
+ * place through write_region/commit_write and read_region/commit_read.
+ */
+template<typename _value_t>
+class RingBuffer {
+private:
+	std::vector<_value_t, AlignedAllocator<_value_t>> buffer;
+	/// Total number of elements ever written. Only modified by the producer
+	alignas(DEFAULT_BUFFER_ALIGNMENT) std::atomic<size_t> write_index = 0;
+	/// Total number of elements ever read. Only modified by the consumer
+	alignas(DEFAULT_BUFFER_ALIGNMENT) std::atomic<size_t> read_index  = 0;
+
+public:
+	explicit RingBuffer(const size_t capacity) :
+		buffer(capacity)
+	{ }
+
+	RingBuffer(const RingBuffer& rhs) = delete;
+	RingBuffer& operator=(const RingBuffer& rhs) = delete;
+
+	size_t capacity() const {
+		return this->buffer.size();
+	}
+
+	/**
+	 * @return Number of elements available to the consumer
+	 */
+	size_t size() const {
+		return this->write_index.load(std::memory_order_acquire) - this->read_index.load(std::memory_order_acquire);
+	}
+
+	/**
+	 * @return Number of elements that the producer may write
+	 */
+	size_t free_space() const {
+		return this->capacity() - this->size();
+	}
+
+	/**
+	 * @brief  Producer only. Contiguous region that may be written to before calling commit_write
+	 * @return Writable region, which may be smaller than free_space() when the free space wraps around
+	 */
+	std::span<_value_t> write_region() {
+		const size_t write = this->write_index.load(std::memory_order_relaxed);
+		const size_t read  = this->read_index.load(std::memory_order_acquire);
+		const size_t start = write % this->capacity();
+		const size_t len   = std::min(this->capacity() - (write - read), this->capacity() - start);
+
+		return std::span<_value_t>(this->buffer.data() + start, len);
+	}
+
+	/**
+	 * @brief Producer only. Publish num_elements elements of the write region to the consumer
+	 */
+	void commit_write(const size_t num_elements) {
+		this->write_index.store(this->write_index.load(std::memory_order_relaxed) + num_elements, std::memory_order_release);
+	}
+
+	/**
+	 * @brief  Consumer only. Contiguous region that may be read from before calling commit_read
+	 * @return Readable region, which may be smaller than size() when the data wraps around
+	 */
+	std::span<const _value_t> read_region() const {
+		const size_t read  = this->read_index.load(std::memory_order_relaxed);
+		const size_t write = this->write_index.load(std::memory_order_acquire);
+		const size_t start = read % this->capacity();
+		const size_t len   = std::min(write - read, this->capacity() - start);
+
+		return std::span<const _value_t>(this->buffer.data() + start, len);
+	}
+
+	/**
+	 * @brief Consumer only. Release num_elements elements of the read region back to the producer
+	 */
+	void commit_read(const size_t num_elements) {
+		this->read_index.store(this->read_index.load(std::memory_order_relaxed) + num_elements, std::memory_order_release);
+	}
+
+	/**
+	 * @brief  Producer only. Copy as many elements as will fit into the buffer
+	 * @return Number of elements written
+	 */
+	size_t write(const _value_t* const values, const size_t num_values) {
+		size_t num_written = 0;
+
+		while (num_written < num_values) {
+			const std::span<_value_t> region = this->write_region();
+			const size_t len = std::min(region.size(), num_values - num_written);
+
+			if (len == 0) {
+				break;
+			}
+
+			std::copy_n(values + num_written, len, region.data());
+			this->commit_write(len);
+			num_written += len;
+		}
+
+		return num_written;
+	}
+
+	/**
+	 * @brief  Consumer only. Copy as many elements as are available out of the buffer
+	 * @return Number of elements read
+	 */
+	size_t read(_value_t* const values, const size_t num_values) {
+		size_t num_read = 0;
+
+		while (num_read < num_values) {
+			const std::span<const _value_t> region = this->read_region();
+			const size_t len = std::min(region.size(), num_values - num_read);
+
+			if (len == 0) {
+				break;
+			}
+
+			std::copy_n(region.data(), len, values + num_read);
+			this->commit_read(len);
+			num_read += len;
+		}
+
+		return num_read;
+	}
+
+	/**
+	 * @return Producer only. Total number of elements that have been written
+	 */
+	size_t write_position() const {
+		return this->write_index.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief Consumer only. Discard every element that was written before the
+	 * given write position, as returned by write_position()
+	 */
+	void discard_until(const size_t position) {
+		if (position > this->read_index.load(std::memory_order_relaxed)) {
+			this->read_index.store(position, std::memory_order_release);
+		}
+	}
+};
+} // namespace dsp
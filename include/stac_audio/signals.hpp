@@ -1,109 +1,430 @@
-#pragma once
-
-#include <functional>
-#include <vector>
-#include <array>
-#include <span>
-#include <tuple>
-#include <type_traits>
-
-#include "dsp_declarations.hpp"
-
-namespace dsp {
-template<typename _sample_t>
-struct Frame {
-	using sample_type = _sample_t;
-
-	_sample_t left_sample  = SAMPLE_SILENCE;
-	_sample_t right_sample = SAMPLE_SILENCE;
-
-	constexpr Frame() noexcept = default;
-
-	constexpr Frame(const _sample_t left_sample, const _sample_t right_sample) noexcept :
-		left_sample(left_sample),
-		right_sample(right_sample)
-	{ }
-};
-
-// TODO make this into a class and initialize the class to SAMPLE_SILENCE by default
-// check ArrTest in main.cpp for guidance on how to do this
-template<typename _sample_t, std::size_t _capacity>
-class Wave : public std::array<Frame<_sample_t>, _capacity> {
-public:
-	using sample_type = _sample_t;
-
-private:
-	// inherit constructors from parent
-	using __Parent = std::array<Frame<_sample_t>, _capacity>;
-	using __Parent::__Parent;
-	/**
-	 * @brief  Populate the wave with the provided samples
-	 * @param  samples Span of samples to write to the wave
-	 * @param  start_index Start index of the samples to write to the wave
-	 * @
-	 * @return Number of samples written to the wave
-	 */
-	//int32_t populate(const std::span<_sample_t>::iterator samples, const size_t start_index, const size_t len) {
-	//	size_t num_samples_written = 0;
-
-	//	for (auto it = begin; it != end && num_samples_written < _capacity; it++) {
-	//		this->at(num_samples_written++) = *it;
-	//	}
-
-	//	return num_samples_written;
-	//}
-};
-
-template<typename _sample_t>
-struct Signal {
-	using sample_type = _sample_t;
-
-	/// Default sample rate in KHz
-	static constexpr sample_rate_t DEFAULT_SAMPLE_RATE = 44100;
-	/// Sample rate in KHz
-	sample_rate_t sample_rate = DEFAULT_SAMPLE_RATE;
-	std::vector<Frame<_sample_t>> frames;
-
-	Signal() = default;
-
-	explicit Signal(const uint32_t sample_rate) :
-		sample_rate(sample_rate)
-	{ }
-
-	explicit Signal(const std::vector<Frame<_sample_t>>& frames) :
-		frames(frames)
-	{ }
-
-	Signal(const uint32_t sample_rate, const std::vector<Frame<_sample_t>>& frames) :
-		sample_rate(sample_rate),
-		frames(frames)
-	{ }
-
-	///**
-	// * @brief Populate a wave starting at the given sample index
-	// * @param wave The wave to populate
-	// * @param time Time in ms to begin populating the wave from
-	// * @return Range of the sample indices
-	// */
-	//template<size_t _capacity>
-	//int32_t populate_wave(Wave<_sample_t, _capacity>& wave, size_t sample_index) const {
-	//	//const size_t sample_index = time * (this->m_sample_rate / 1000.0);
-	//	// TODO make this return a range where the start is the sample_index and the end is where the wave ends
-
-	//	if (sample_index >= this->frames.size()) {
-	//		return -1;
-	//	}
-
-	//	for (size_t i = 0; i < wave.size() && (sample_index + i) < this->frames.size(); i++) {
-	//		wave.at(i) = this->frames.at(sample_index + i);
-	//	}
-
-	//	return sample_index;
-	//}
-};
-} // namespace dsp
-
-/// Tuple size specialization for the Wave
-template<typename _sample_t, std::size_t _capacity>
-struct std::tuple_size<dsp::Wave<_sample_t, _capacity>> : public std::integral_constant<std::size_t, _capacity>
-{};
+#pragma once
+
+#include <functional>
+#include <vector>
+#include <array>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <algorithm>
+
+#include "dsp_declarations.hpp"
+#include "aligned_allocator.hpp"
+
+namespace dsp {
+/**
+ * @brief A single sample for each of _num_channels channels. The mono and
+ * stereo layouts are specialized so they may be accessed by name.
+ */
+template<typename _sample_t, std::size_t _num_channels = NUM_CHANNELS>
+struct Frame {
+	using sample_type = _sample_t;
+
+	static constexpr std::size_t num_channels = _num_channels;
+
+	static_assert(_num_channels > 0, "A frame must contain at least one channel");
+
+	std::array<_sample_t, _num_channels> samples = { };
+
+	constexpr Frame() noexcept = default;
+
+	constexpr _sample_t& operator[](const std::size_t channel) noexcept {
+		return this->samples[channel];
+	}
+
+	constexpr const _sample_t& operator[](const std::size_t channel) const noexcept {
+		return this->samples[channel];
+	}
+};
+
+template<typename _sample_t>
+struct Frame<_sample_t, 1> {
+	using sample_type = _sample_t;
+
+	static constexpr std::size_t num_channels = 1;
+
+	_sample_t sample = SAMPLE_SILENCE;
+
+	constexpr Frame() noexcept = default;
+
+	constexpr explicit Frame(const _sample_t sample) noexcept :
+		sample(sample)
+	{ }
+
+	constexpr _sample_t& operator[](const std::size_t) noexcept {
+		return this->sample;
+	}
+
+	constexpr const _sample_t& operator[](const std::size_t) const noexcept {
+		return this->sample;
+	}
+};
+
+template<typename _sample_t>
+struct Frame<_sample_t, 2> {
+	using sample_type = _sample_t;
+
+	static constexpr std::size_t num_channels = 2;
+
+	_sample_t left_sample  = SAMPLE_SILENCE;
+	_sample_t right_sample = SAMPLE_SILENCE;
+
+	constexpr Frame() noexcept = default;
+
+	constexpr Frame(const _sample_t left_sample, const _sample_t right_sample) noexcept :
+		left_sample(left_sample),
+		right_sample(right_sample)
+	{ }
+
+	constexpr _sample_t& operator[](const std::size_t channel) noexcept {
+		return (channel == 0) ? this->left_sample : this->right_sample;
+	}
+
+	constexpr const _sample_t& operator[](const std::size_t channel) const noexcept {
+		return (channel == 0) ? this->left_sample : this->right_sample;
+	}
+};
+
+// TODO make this into a class and initialize the class to SAMPLE_SILENCE by default
+// check ArrTest in main.cpp for guidance on how to do this
+template<typename _sample_t, std::size_t _capacity, std::size_t _num_channels = NUM_CHANNELS>
+class Wave : public std::array<Frame<_sample_t, _num_channels>, _capacity> {
+public:
+	using sample_type = _sample_t;
+	using frame_type  = Frame<_sample_t, _num_channels>;
+
+	static constexpr std::size_t num_channels = _num_channels;
+
+private:
+	// inherit constructors from parent
+	using __Parent = std::array<Frame<_sample_t, _num_channels>, _capacity>;
+	using __Parent::__Parent;
+	/**
+	 * @brief  Populate the wave with the provided samples
+	 * @param  samples Span of samples to write to the wave
+	 * @param  start_index Start index of the samples to write to the wave
+	 * @
+	 * @return Number of samples written to the wave
+	 */
+	//int32_t populate(const std::span<_sample_t>::iterator samples, const size_t start_index, const size_t len) {
+	//	size_t num_samples_written = 0;
+
+	//	for (auto it = begin; it != end && num_samples_written < _capacity; it++) {
+	//		this->at(num_samples_written++) = *it;
+	//	}
+
+	//	return num_samples_written;
+	//}
+};
+
+template<typename _sample_t, std::size_t _num_channels = NUM_CHANNELS>
+struct Signal {
+	using sample_type = _sample_t;
+	using frame_type  = Frame<_sample_t, _num_channels>;
+
+	static constexpr std::size_t num_channels = _num_channels;
+
+	/// Default sample rate in KHz
+	static constexpr sample_rate_t DEFAULT_SAMPLE_RATE = 44100;
+	/// Sample rate in KHz
+	sample_rate_t sample_rate = DEFAULT_SAMPLE_RATE;
+	std::vector<frame_type> frames;
+
+	Signal() = default;
+
+	explicit Signal(const uint32_t sample_rate) :
+		sample_rate(sample_rate)
+	{ }
+
+	explicit Signal(const std::vector<frame_type>& frames) :
+		frames(frames)
+	{ }
+
+	Signal(const uint32_t sample_rate, const std::vector<frame_type>& frames) :
+		sample_rate(sample_rate),
+		frames(frames)
+	{ }
+
+	///**
+	// * @brief Populate a wave starting at the given sample index
+	// * @param wave The wave to populate
+	// * @param time Time in ms to begin populating the wave from
+	// * @return Range of the sample indices
+	// */
+	//template<size_t _capacity>
+	//int32_t populate_wave(Wave<_sample_t, _capacity>& wave, size_t sample_index) const {
+	//	//const size_t sample_index = time * (this->m_sample_rate / 1000.0);
+	//	// TODO make this return a range where the start is the sample_index and the end is where the wave ends
+
+	//	if (sample_index >= this->frames.size()) {
+	//		return -1;
+	//	}
+
+	//	for (size_t i = 0; i < wave.size() && (sample_index + i) < this->frames.size(); i++) {
+	//		wave.at(i) = this->frames.at(sample_index + i);
+	//	}
+
+	//	return sample_index;
+	//}
+};
+
+/**
+ * @brief Read-only, non-owning view of interleaved samples with a channel count
+ * that is only known at runtime, such as the data of a memory-mapped file
+ */
+template<typename _sample_t>
+struct SignalView {
+	using sample_type = _sample_t;
+
+	const _sample_t* samples      = nullptr;
+	size_t           num_frames   = 0;
+	size_t           num_channels = 0;
+	sample_rate_t    sample_rate  = Signal<_sample_t>::DEFAULT_SAMPLE_RATE;
+
+	constexpr SignalView() noexcept = default;
+
+	constexpr SignalView(const _sample_t* const samples, const size_t num_frames, const size_t num_channels,
+	                     const sample_rate_t sample_rate) noexcept :
+		samples(samples),
+		num_frames(num_frames),
+		num_channels(num_channels),
+		sample_rate(sample_rate)
+	{ }
+
+	template<std::size_t _num_channels>
+	SignalView(const Signal<_sample_t, _num_channels>& signal) noexcept :
+		samples(reinterpret_cast<const _sample_t*>(signal.frames.data())),
+		num_frames(signal.frames.size()),
+		num_channels(_num_channels),
+		sample_rate(signal.sample_rate)
+	{ }
+
+	constexpr bool empty() const noexcept {
+		return this->num_frames == 0;
+	}
+
+	constexpr _sample_t sample(const size_t frame_index, const size_t channel_index) const noexcept {
+		return this->samples[frame_index * this->num_channels + channel_index];
+	}
+
+	/**
+	 * @brief  View the samples as frames of _num_channels channels
+	 * @return Span over the frames, or an empty span if the channel count does not match
+	 */
+	template<std::size_t _num_channels>
+	std::span<const Frame<_sample_t, _num_channels>> frames() const noexcept {
+		static_assert(sizeof(Frame<_sample_t, _num_channels>) == sizeof(_sample_t) * _num_channels,
+		              "Frame must be laid out as _num_channels contiguous samples");
+
+		if (this->num_channels != _num_channels) {
+			return { };
+		}
+
+		return std::span<const Frame<_sample_t, _num_channels>>(
+			reinterpret_cast<const Frame<_sample_t, _num_channels>*>(this->samples), this->num_frames);
+	}
+};
+
+/**
+ * @brief Signal stored as one contiguous, aligned buffer per channel
+ * (structure-of-arrays) rather than as interleaved frames. Per-channel
+ * kernels such as filters and fftw may operate directly on the channel buffers.
+ */
+template<typename _sample_t>
+struct PlanarSignal {
+	using sample_type  = _sample_t;
+	using channel_type = std::vector<_sample_t, AlignedAllocator<_sample_t>>;
+
+	/// Default sample rate in KHz
+	static constexpr sample_rate_t DEFAULT_SAMPLE_RATE = 44100;
+	/// Sample rate in KHz
+	sample_rate_t sample_rate = DEFAULT_SAMPLE_RATE;
+	/// One buffer per channel. Every channel contains the same number of samples
+	std::vector<channel_type> channels;
+
+	PlanarSignal() = default;
+
+	explicit PlanarSignal(const sample_rate_t sample_rate) :
+		sample_rate(sample_rate)
+	{ }
+
+	PlanarSignal(const sample_rate_t sample_rate, const size_t num_channels, const size_t num_frames) :
+		sample_rate(sample_rate) {
+		this->resize(num_channels, num_frames);
+	}
+
+	/**
+	 * @brief Construct a planar signal from an interleaved signal
+	 * @param signal Interleaved signal to copy the samples of
+	 */
+	template<std::size_t _num_channels>
+	explicit PlanarSignal(const Signal<_sample_t, _num_channels>& signal) :
+		sample_rate(signal.sample_rate) {
+		this->assign_interleaved(signal);
+	}
+
+	size_t num_channels() const {
+		return this->channels.size();
+	}
+
+	size_t num_frames() const {
+		return this->channels.empty() ? 0 : this->channels.front().size();
+	}
+
+	/**
+	 * @brief Resize every channel. New samples are set to SAMPLE_SILENCE
+	 * @param num_channels Number of channels the signal should contain
+	 * @param num_frames Number of samples each channel should contain
+	 */
+	void resize(const size_t num_channels, const size_t num_frames) {
+		this->channels.resize(num_channels);
+
+		for (channel_type& channel : this->channels) {
+			channel.resize(num_frames, static_cast<_sample_t>(SAMPLE_SILENCE));
+		}
+	}
+
+	/**
+	 * @brief  View of the samples of a single channel
+	 * @param  channel_index Index of the channel
+	 * @return Span over the channel's contiguous samples
+	 */
+	std::span<_sample_t> channel(const size_t channel_index) {
+		return std::span<_sample_t>(this->channels.at(channel_index));
+	}
+
+	std::span<const _sample_t> channel(const size_t channel_index) const {
+		return std::span<const _sample_t>(this->channels.at(channel_index));
+	}
+
+	/**
+	 * @brief Replace the contents of the signal with the samples of an interleaved buffer
+	 * @param samples Interleaved samples, num_frames * num_channels long
+	 * @param num_frames Number of frames contained in samples
+	 * @param num_channels Number of channels contained in samples
+	 */
+	void assign_interleaved(const _sample_t* const samples, const size_t num_frames, const size_t num_channels) {
+		this->resize(num_channels, num_frames);
+		this->write_interleaved(samples, 0, num_frames);
+	}
+
+	template<std::size_t _num_channels>
+	void assign_interleaved(const Signal<_sample_t, _num_channels>& signal) {
+		static_assert(sizeof(Frame<_sample_t, _num_channels>) == sizeof(_sample_t) * _num_channels,
+		              "Frame must be laid out as _num_channels contiguous samples");
+
+		this->sample_rate = signal.sample_rate;
+		this->assign_interleaved(reinterpret_cast<const _sample_t*>(signal.frames.data()),
+		                         signal.frames.size(), _num_channels);
+	}
+
+	void assign_interleaved(const SignalView<_sample_t>& view) {
+		this->sample_rate = view.sample_rate;
+		this->assign_interleaved(view.samples, view.num_frames, view.num_channels);
+	}
+
+	/**
+	 * @brief Deinterleave samples into the channels, starting at a given frame.
+	 * The signal must already be large enough to hold the samples.
+	 * @param samples Interleaved samples, num_frames * num_channels() long
+	 * @param frame_index Index of the first frame to write to
+	 * @param num_frames Number of frames to write
+	 */
+	void write_interleaved(const _sample_t* const samples, const size_t frame_index, const size_t num_frames) {
+		const size_t num_channels = this->num_channels();
+
+		if (num_channels == 2) {
+			_sample_t* const left  = this->channels[0].data() + frame_index;
+			_sample_t* const right = this->channels[1].data() + frame_index;
+
+			for (size_t i = 0; i < num_frames; i++) {
+				left[i]  = samples[i * 2];
+				right[i] = samples[i * 2 + 1];
+			}
+		} else if (num_channels == 1) {
+			std::copy_n(samples, num_frames, this->channels[0].data() + frame_index);
+		} else {
+			for (size_t c = 0; c < num_channels; c++) {
+				_sample_t* const channel = this->channels[c].data() + frame_index;
+
+				for (size_t i = 0; i < num_frames; i++) {
+					channel[i] = samples[i * num_channels + c];
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief Interleave frames of the signal into a buffer
+	 * @param samples Destination buffer, num_frames * num_channels() long
+	 * @param frame_index Index of the first frame to read from
+	 * @param num_frames Number of frames to read
+	 */
+	void read_interleaved(_sample_t* const samples, const size_t frame_index, const size_t num_frames) const {
+		const size_t num_channels = this->num_channels();
+
+		if (num_channels == 2) {
+			const _sample_t* const left  = this->channels[0].data() + frame_index;
+			const _sample_t* const right = this->channels[1].data() + frame_index;
+
+			for (size_t i = 0; i < num_frames; i++) {
+				samples[i * 2]     = left[i];
+				samples[i * 2 + 1] = right[i];
+			}
+		} else if (num_channels == 1) {
+			std::copy_n(this->channels[0].data() + frame_index, num_frames, samples);
+		} else {
+			for (size_t c = 0; c < num_channels; c++) {
+				const _sample_t* const channel = this->channels[c].data() + frame_index;
+
+				for (size_t i = 0; i < num_frames; i++) {
+					samples[i * num_channels + c] = channel[i];
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief  Convert the signal into an interleaved signal of _num_channels channels.
+	 * A mono signal is duplicated into every channel. Otherwise, missing channels
+	 * are silent and extra channels are dropped.
+	 * @return Interleaved copy of the signal
+	 */
+	template<std::size_t _num_channels = NUM_CHANNELS>
+	Signal<_sample_t, _num_channels> to_interleaved() const {
+		Signal<_sample_t, _num_channels> signal(this->sample_rate);
+		const size_t num_frames = this->num_frames();
+
+		signal.frames.resize(num_frames);
+
+		if (this->num_channels() == _num_channels) {
+			this->read_interleaved(reinterpret_cast<_sample_t*>(signal.frames.data()), 0, num_frames);
+		} else if (this->num_channels() == 1) {
+			const _sample_t* const mono = this->channels[0].data();
+
+			for (size_t i = 0; i < num_frames; i++) {
+				for (size_t c = 0; c < _num_channels; c++) {
+					signal.frames[i][c] = mono[i];
+				}
+			}
+		} else {
+			const size_t num_channels = std::min(this->num_channels(), _num_channels);
+
+			for (size_t c = 0; c < num_channels; c++) {
+				const _sample_t* const channel = this->channels[c].data();
+
+				for (size_t i = 0; i < num_frames; i++) {
+					signal.frames[i][c] = channel[i];
+				}
+			}
+		}
+
+		return signal;
+	}
+};
+} // namespace dsp
+
+/// Tuple size specialization for the Wave
+template<typename _sample_t, std::size_t _capacity, std::size_t _num_channels>
+struct std::tuple_size<dsp::Wave<_sample_t, _capacity, _num_channels>> : public std::integral_constant<std::size_t, _capacity>
+{};
@@ -0,0 +1,10 @@
+#pragma once
+
+/*
+ * Detects the SIMD instruction sets that the DSP kernels may use. Every kernel
+ * with a SIMD path also has a scalar path, which is used when none is available.
+ */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define STAC_AUDIO_SSE2 1
+	#include <emmintrin.h>
+#endif
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <span>
+#include <algorithm>
+#include <cstddef>
+
+#include "signals.hpp"
+
+namespace dsp {
+/**
+ * @brief Parameter that moves linearly to a new target over a fixed number of
+ * samples instead of jumping to it, which would be heard as a click or, for
+ * repeated changes, as zipper noise. Owned and advanced by the audio thread.
+ * Targets set by other threads should be delivered through a dsp::TripleBuffer
+ * or the message queue.
+ */
+template<typename _value_t>
+class SmoothedValue {
+public:
+	/// Default number of samples of a ramp, which is about 10ms at 48kHz
+	static constexpr size_t DEFAULT_RAMP_LENGTH = 512;
+
+private:
+	_value_t current;
+	_value_t target;
+	_value_t step        = _value_t(0);
+	size_t   ramp_length = DEFAULT_RAMP_LENGTH;
+	/// Number of samples until the target is reached
+	size_t   remaining   = 0;
+
+public:
+	explicit SmoothedValue(const _value_t initial = _value_t(), const size_t ramp_length = DEFAULT_RAMP_LENGTH) :
+		current(initial),
+		target(initial),
+		ramp_length(ramp_length)
+	{ }
+
+	/**
+	 * @brief Ramp from the current value to the target over the ramp length
+	 */
+	void set_target(const _value_t target) {
+		this->target = target;
+
+		if (this->ramp_length == 0 || target == this->current) {
+			this->set_immediate(target);
+		} else {
+			this->remaining = this->ramp_length;
+			this->step = (target - this->current) / static_cast<_value_t>(this->ramp_length);
+		}
+	}
+
+	/**
+	 * @brief Jump to a value without ramping, e.g. before playback starts
+	 */
+	void set_immediate(const _value_t value) {
+		this->current = value;
+		this->target = value;
+		this->remaining = 0;
+	}
+
+	/**
+	 * @brief Set the length of ramps started by later calls to set_target
+	 */
+	void set_ramp_length(const size_t ramp_length) {
+		this->ramp_length = ramp_length;
+	}
+
+	_value_t get_current() const {
+		return this->current;
+	}
+
+	_value_t get_target() const {
+		return this->target;
+	}
+
+	bool is_smoothing() const {
+		return this->remaining > 0;
+	}
+
+	/**
+	 * @return Value of the next sample
+	 */
+	_value_t next() {
+		if (this->remaining > 0) {
+			this->remaining--;
+			this->current = (this->remaining == 0) ? this->target : this->current + this->step;
+		}
+
+		return this->current;
+	}
+
+	/**
+	 * @brief Advance by num_samples samples without reading the values
+	 */
+	void skip(const size_t num_samples) {
+		if (num_samples >= this->remaining) {
+			this->set_immediate(this->target);
+		} else {
+			this->remaining -= num_samples;
+			this->current += this->step * static_cast<_value_t>(num_samples);
+		}
+	}
+
+	/**
+	 * @brief Multiply every channel of each frame by the value of its sample, e.g. to apply a gain
+	 */
+	template<typename _sample_t, size_t _num_channels>
+	void apply(const std::span<Frame<_sample_t, _num_channels>> frames) {
+		size_t i = 0;
+
+		for (; i < frames.size() && this->remaining > 0; i++) {
+			const _sample_t value = static_cast<_sample_t>(this->next());
+
+			for (size_t c = 0; c < _num_channels; c++) {
+				frames[i][c] *= value;
+			}
+		}
+
+		// constant for the rest of the block
+		const _sample_t value = static_cast<_sample_t>(this->current);
+
+		if (value == _sample_t(1)) {
+			return;
+		}
+
+		for (; i < frames.size(); i++) {
+			for (size_t c = 0; c < _num_channels; c++) {
+				frames[i][c] *= value;
+			}
+		}
+	}
+
+	template<typename _sample_t, size_t _capacity, size_t _num_channels>
+	void apply(Wave<_sample_t, _capacity, _num_channels>& wave) {
+		this->apply(std::span<Frame<_sample_t, _num_channels>>(wave));
+	}
+};
+} // namespace dsp
@@ -0,0 +1,240 @@
+#pragma once
+
+#include <vector>
+#include <span>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+#include "signals.hpp"
+#include "window.hpp"
+#include "aligned_allocator.hpp"
+#include "fft_converter.hpp"
+
+/**
+ * @brief Streaming short-time Fourier transform with overlap-add resynthesis.
+ *
+ * Samples may be pushed in blocks of any size, such as the dsp::FRAMES_PER_BUFFER
+ * frames of an audio callback. Every hop_size samples, the last fft_size samples
+ * of each channel are windowed and transformed, the spectrum is handed to a
+ * processor, and the processed spectrum is transformed back, windowed again
+ * and overlap-added into the output. With an unmodified spectrum the output is
+ * the input delayed by latency() samples, for any window and hop whose
+ * overlapping squared windows do not sum to zero.
+ *
+ * Every buffer is allocated by the constructor, so process and analyze are
+ * real-time safe as long as the processor is.
+ */
+template<typename _sample_t> requires dsp::fft::FFTWSample<_sample_t>
+class STFTProcessor {
+public:
+	using converter_type = FFTConverter<_sample_t>;
+	using complex_type   = typename converter_type::complex_type;
+
+private:
+	using __Buffer        = std::vector<_sample_t, dsp::AlignedAllocator<_sample_t>>;
+	using __ComplexBuffer = std::vector<complex_type, dsp::AlignedAllocator<complex_type>>;
+
+	struct ChannelState {
+		/// Last fft_size input samples. The newest hop_size samples are written to the end
+		__Buffer        input;
+		/// Overlap-added output. The first hop_size samples are complete after every frame
+		__Buffer        accumulator;
+		/// Completed output samples, read out while the next hop is being collected
+		__Buffer        output;
+		__ComplexBuffer spectrum;
+	};
+
+	size_t                    fft_size;
+	size_t                    hop_size;
+	converter_type            converter;
+	__Buffer                  analysis_window;
+	/// Analysis window divided by the overlapping squared windows and by fft_size
+	__Buffer                  synthesis_window;
+	/// Windowed frame, transformed in place of the caller's samples
+	__Buffer                  frame;
+	std::vector<ChannelState> channels;
+	/// Number of samples of the current hop that have been pushed. Equal for every channel
+	size_t                    hop_position = 0;
+
+public:
+	/**
+	 * @param fft_size Number of samples per frame. Also the length of the window
+	 * @param hop_size Number of samples between the starts of consecutive frames. At most fft_size
+	 * @param window_type Window applied before the forward and after the inverse transform
+	 * @param num_channels Number of independent channels
+	 * @param allocation_strategy How long fftw may spend finding the fastest plan
+	 */
+	STFTProcessor(const size_t fft_size, const size_t hop_size, const dsp::WindowType window_type = dsp::WindowType::HANN,
+	              const size_t num_channels = dsp::NUM_CHANNELS,
+	              const typename converter_type::AllocationStrategy allocation_strategy =
+	                  converter_type::AllocationStrategy::IMPATIENT) :
+			fft_size(fft_size),
+			hop_size(hop_size),
+			converter(allocation_strategy, fft_size, true),
+			analysis_window(fft_size),
+			synthesis_window(fft_size),
+			frame(fft_size),
+			channels(num_channels) {
+		assert(hop_size > 0 && hop_size <= fft_size);
+
+		dsp::fill_window<_sample_t>(window_type, this->analysis_window);
+
+		for (size_t i = 0; i < fft_size; i++) {
+			double overlap = 0.0;
+
+			for (size_t j = i % hop_size; j < fft_size; j += hop_size) {
+				overlap += static_cast<double>(this->analysis_window[j]) * static_cast<double>(this->analysis_window[j]);
+			}
+
+			this->synthesis_window[i] = (overlap > 0.0) ?
+				static_cast<_sample_t>(this->analysis_window[i] / (overlap * static_cast<double>(fft_size))) : _sample_t(0);
+		}
+
+		for (ChannelState& channel : this->channels) {
+			channel.input.assign(fft_size, _sample_t(0));
+			channel.accumulator.assign(fft_size, _sample_t(0));
+			channel.output.assign(hop_size, _sample_t(0));
+			channel.spectrum.assign(this->converter.get_num_complex_samples(), complex_type(0));
+		}
+	}
+
+	STFTProcessor(const STFTProcessor& rhs) = delete;
+	STFTProcessor& operator=(const STFTProcessor& rhs) = delete;
+
+	size_t get_fft_size() const {
+		return this->fft_size;
+	}
+
+	size_t get_hop_size() const {
+		return this->hop_size;
+	}
+
+	size_t num_channels() const {
+		return this->channels.size();
+	}
+
+	size_t num_bins() const {
+		return this->converter.get_num_complex_samples();
+	}
+
+	/**
+	 * @return Number of samples by which process delays its output
+	 */
+	size_t latency() const {
+		return this->fft_size;
+	}
+
+	/**
+	 * @brief Clear every channel's history, as if no samples had been pushed
+	 */
+	void reset() {
+		for (ChannelState& channel : this->channels) {
+			std::fill(channel.input.begin(), channel.input.end(), _sample_t(0));
+			std::fill(channel.accumulator.begin(), channel.accumulator.end(), _sample_t(0));
+			std::fill(channel.output.begin(), channel.output.end(), _sample_t(0));
+		}
+
+		this->hop_position = 0;
+	}
+
+	/**
+	 * @brief Push samples of every channel and pull the same number of resynthesized samples
+	 * @param samples Interleaved samples of num_channels() channels, replaced by the output
+	 * @param num_frames Number of frames of samples
+	 * @param processor Called as processor(std::span<complex_type> spectrum, size_t channel) for
+	 * every frame of every channel, and may modify the spectrum in place
+	 */
+	template<typename _processor_t>
+	void process(_sample_t* const samples, const size_t num_frames, _processor_t&& processor) {
+		this->push<true>(samples, num_frames, processor);
+	}
+
+	template<size_t _capacity, size_t _num_channels, typename _processor_t>
+	void process(dsp::Wave<_sample_t, _capacity, _num_channels>& wave, _processor_t&& processor) {
+		static_assert(sizeof(dsp::Frame<_sample_t, _num_channels>) == sizeof(_sample_t) * _num_channels,
+		              "Frame must be laid out as _num_channels contiguous samples");
+		assert(_num_channels == this->num_channels());
+
+		this->push<true>(reinterpret_cast<_sample_t*>(wave.data()), _capacity, processor);
+	}
+
+	/**
+	 * @brief Push samples of every channel without resynthesizing them, e.g. for offline analysis
+	 * @param samples Interleaved samples of num_channels() channels. Not modified
+	 * @param num_frames Number of frames of samples
+	 * @param processor Called as processor(std::span<complex_type> spectrum, size_t channel) for
+	 * every frame of every channel
+	 */
+	template<typename _processor_t>
+	void analyze(const _sample_t* const samples, const size_t num_frames, _processor_t&& processor) {
+		this->push<false>(const_cast<_sample_t*>(samples), num_frames, processor);
+	}
+
+private:
+	template<bool _resynthesize, typename _processor_t>
+	void push(_sample_t* const samples, const size_t num_frames, _processor_t& processor) {
+		const size_t num_channels = this->channels.size();
+		const size_t history = this->fft_size - this->hop_size;
+		size_t frame_index = 0;
+
+		while (frame_index < num_frames) {
+			const size_t len = std::min(num_frames - frame_index, this->hop_size - this->hop_position);
+
+			for (size_t c = 0; c < num_channels; c++) {
+				ChannelState& channel = this->channels[c];
+				_sample_t* const input = channel.input.data() + history + this->hop_position;
+				const _sample_t* const output = channel.output.data() + this->hop_position;
+				_sample_t* const block = samples + frame_index * num_channels + c;
+
+				// the input is copied out before the output is copied in, so the samples may be replaced in place
+				for (size_t i = 0; i < len; i++) {
+					input[i] = block[i * num_channels];
+
+					if constexpr (_resynthesize) {
+						block[i * num_channels] = output[i];
+					}
+				}
+			}
+
+			this->hop_position += len;
+			frame_index += len;
+
+			if (this->hop_position == this->hop_size) {
+				for (size_t c = 0; c < num_channels; c++) {
+					this->transform<_resynthesize>(this->channels[c], c, processor);
+				}
+
+				this->hop_position = 0;
+			}
+		}
+	}
+
+	template<bool _resynthesize, typename _processor_t>
+	void transform(ChannelState& channel, const size_t channel_index, _processor_t& processor) {
+		const size_t history = this->fft_size - this->hop_size;
+
+		for (size_t i = 0; i < this->fft_size; i++) {
+			this->frame[i] = channel.input[i] * this->analysis_window[i];
+		}
+
+		// the oldest hop has been used by its last frame
+		std::copy(channel.input.begin() + this->hop_size, channel.input.end(), channel.input.begin());
+
+		this->converter.forward(this->frame.data(), channel.spectrum.data());
+		processor(std::span<complex_type>(channel.spectrum), channel_index);
+
+		if constexpr (_resynthesize) {
+			// the synthesis window includes the 1 / fft_size normalization
+			this->converter.inverse(channel.spectrum.data(), this->frame.data(), converter_type::Normalization::NONE);
+
+			for (size_t i = 0; i < this->fft_size; i++) {
+				channel.accumulator[i] += this->frame[i] * this->synthesis_window[i];
+			}
+
+			std::copy_n(channel.accumulator.begin(), this->hop_size, channel.output.begin());
+			std::copy(channel.accumulator.begin() + this->hop_size, channel.accumulator.end(), channel.accumulator.begin());
+			std::fill(channel.accumulator.begin() + history, channel.accumulator.end(), _sample_t(0));
+		}
+	}
+};
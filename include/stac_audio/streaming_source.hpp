@@ -0,0 +1,192 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <string>
+#include <span>
+#include <cstdint>
+#include <sndfile.h>
+
+#include "dsp_declarations.hpp"
+#include "signals.hpp"
+#include "ring_buffer.hpp"
+
+/**
+ * @brief Plays a sound file from disk without decoding the whole file up front.
+ * A background reader thread decodes the file through libsndfile into a lock-free
+ * ring buffer, which the audio thread reads from. Memory use is constant no matter
+ * how long the file is.
+ *
+ * open/close must be called from the control thread. read, seek, and position
+ * are real-time safe and may only be called from the audio thread.
+ */
+class StreamingSource {
+public:
+	/// Default number of frames buffered ahead of the audio thread
+	static constexpr size_t DEFAULT_BUFFER_FRAMES = 1 << 16;
+	/// Maximum number of frames decoded by the reader thread at once
+	static constexpr size_t READ_BLOCK_FRAMES = 4096;
+
+private:
+	SNDFILE*                               sf           = nullptr;
+	SF_INFO                                sf_info      = { };
+	bool                                   loop         = false;
+	/// Interleaved samples, in the channel layout of the file
+	std::unique_ptr<dsp::RingBuffer<dsp::sample_t>> ring_buffer;
+	std::thread                            reader_thread;
+	std::atomic<bool>                      running      = false;
+	/// Set by the audio thread once the reader thread has enough work to do
+	std::atomic<bool>                      wake_reader  = false;
+	std::atomic<bool>                      end_of_file  = false;
+	/// Frame to seek to. Written by the audio thread before incrementing seek_generation
+	std::atomic<size_t>                    seek_target  = 0;
+	std::atomic<uint32_t>                  seek_generation = 0;
+	/// Last seek_generation that the reader thread has performed
+	std::atomic<uint32_t>                  handled_generation = 0;
+	/// Ring buffer write position at the time the last seek was performed
+	std::atomic<size_t>                    flush_position = 0;
+	/// Number of audio thread reads that could not be completely filled
+	std::atomic<uint64_t>                  num_underruns = 0;
+	/// Audio thread only. Last generation whose stale data has been discarded
+	uint32_t                               flushed_generation = 0;
+	/// Audio thread only. Index of the next frame that will be read
+	size_t                                 frame_index  = 0;
+
+public:
+	StreamingSource() = default;
+
+	StreamingSource(const StreamingSource& rhs) = delete;
+	StreamingSource& operator=(const StreamingSource& rhs) = delete;
+
+	~StreamingSource();
+
+	/**
+	 * @brief  Open a sound file, decode the first block of it, and start the reader thread
+	 * @param  file_path Path of the sound file to stream
+	 * @param  buffer_frames Number of frames to buffer ahead of the audio thread
+	 * @param  loop Whether to restart from the beginning of the file once the end is reached
+	 * @return Whether the file was able to be opened
+	 */
+	bool open(const std::string& file_path, const size_t buffer_frames = DEFAULT_BUFFER_FRAMES, const bool loop = false);
+	/**
+	 * @brief Stop the reader thread and close the file
+	 */
+	void close();
+
+	bool is_open() const;
+	size_t num_frames() const;
+	size_t num_channels() const;
+	dsp::sample_rate_t sample_rate() const;
+	uint64_t underrun_count() const;
+
+	/**
+	 * @return Whether every frame of a non-looping file has been read. False while a
+	 * seek is pending, and false when no file is open
+	 */
+	bool is_finished() const;
+
+	/**
+	 * @brief Request playback to continue from the given frame. The request is
+	 * handled by the reader thread, and reads return silence until it has been.
+	 * @param frame_index Index of the frame to continue from
+	 * @return Whether the frame index is within the file
+	 */
+	bool seek(const size_t frame_index);
+
+	/**
+	 * @return Index of the next frame that will be read
+	 */
+	size_t position() const;
+
+	/**
+	 * @brief  Read frames, converting from the file's channel layout into the
+	 * frames' layout. Mono is duplicated into every channel, missing channels
+	 * are silent and extra channels are dropped. Frames that are not available
+	 * yet are filled with silence.
+	 * @param  frames Frames to fill
+	 * @return Number of frames that were read from the file
+	 */
+	template<size_t _num_channels>
+	size_t read(const std::span<dsp::Frame<dsp::sample_t, _num_channels>> frames) {
+		size_t num_frames_read = 0;
+
+		if (this->is_seek_complete()) {
+			const size_t file_channels = this->num_channels();
+
+			while (num_frames_read < frames.size()) {
+				const std::span<const dsp::sample_t> region = this->ring_buffer->read_region();
+				const size_t len = std::min(region.size() / file_channels, frames.size() - num_frames_read);
+
+				if (len == 0) {
+					break;
+				}
+
+				copy_frames(region.data(), file_channels, frames.data() + num_frames_read, len);
+				this->ring_buffer->commit_read(len * file_channels);
+				num_frames_read += len;
+			}
+
+			this->advance(num_frames_read);
+
+			if (num_frames_read < frames.size() && !this->end_of_file.load(std::memory_order_acquire)) {
+				this->num_underruns.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+
+		std::fill(frames.begin() + num_frames_read, frames.end(), dsp::Frame<dsp::sample_t, _num_channels>());
+
+		// waking the reader is a system call, so it is only woken once it has half of the
+		// ring buffer to decode. Seeks wake it themselves
+		if (!this->end_of_file.load(std::memory_order_relaxed) &&
+		    this->ring_buffer->free_space() >= this->ring_buffer->capacity() / 2) {
+			this->notify_reader();
+		}
+
+		return num_frames_read;
+	}
+
+	template<size_t _capacity, size_t _num_channels>
+	size_t read(dsp::Wave<dsp::sample_t, _capacity, _num_channels>& wave) {
+		return this->read(std::span<dsp::Frame<dsp::sample_t, _num_channels>>(wave));
+	}
+
+private:
+	template<size_t _num_channels>
+	static void copy_frames(const dsp::sample_t* const samples, const size_t num_channels,
+	                        dsp::Frame<dsp::sample_t, _num_channels>* const frames, const size_t num_frames) {
+		static_assert(sizeof(dsp::Frame<dsp::sample_t, _num_channels>) == sizeof(dsp::sample_t) * _num_channels,
+		              "Frame must be laid out as _num_channels contiguous samples");
+
+		if (num_channels == _num_channels) {
+			std::copy_n(samples, num_frames * _num_channels, reinterpret_cast<dsp::sample_t*>(frames));
+		} else if (num_channels == 1) {
+			for (size_t i = 0; i < num_frames; i++) {
+				for (size_t c = 0; c < _num_channels; c++) {
+					frames[i][c] = samples[i];
+				}
+			}
+		} else {
+			for (size_t i = 0; i < num_frames; i++) {
+				for (size_t c = 0; c < _num_channels; c++) {
+					frames[i][c] = (c < num_channels) ? samples[i * num_channels + c] : dsp::SAMPLE_SILENCE;
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief  Audio thread only. Discard data decoded before the last seek once the reader has performed it
+	 * @return Whether the last requested seek has been performed
+	 */
+	bool is_seek_complete();
+	void advance(const size_t num_frames);
+	void notify_reader();
+
+	/**
+	 * @brief  Decode as many frames as will fit into the ring buffer, up to max_frames
+	 * @return Number of frames decoded
+	 */
+	size_t fill(const size_t max_frames);
+	void reader_loop();
+};
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <span>
+#include <limits>
+#include <cstdint>
+#include <portaudio.h>
+
+#include "ring_buffer.hpp"
+
+/**
+ * @brief What happened during one audio callback, as measured by the audio thread
+ */
+struct CallbackRecord {
+	/// Time spent in the callback in nanoseconds
+	uint64_t              cpu_time_ns        = 0;
+	/// Duration of the buffer in nanoseconds, i.e. the time the callback had to complete
+	uint64_t              buffer_period_ns   = 0;
+	/// Time from the start of the callback until its first frame reaches the DAC in
+	/// nanoseconds, as reported by PortAudio. 0 when the host does not report it
+	int64_t               time_to_dac_ns     = 0;
+	/// paOutputUnderflow, paOutputOverflow, paPrimingOutput, etc. reported for the callback
+	PaStreamCallbackFlags status_flags       = 0;
+	uint32_t              frames_per_buffer  = 0;
+	/// Index of the next frame of the source that will be played
+	size_t                sample_index       = 0;
+};
+
+/**
+ * @brief Lock-free channel of CallbackRecords from the audio thread to the control
+ * thread. When the control thread falls behind, new records are dropped and counted
+ * rather than blocking the audio thread.
+ */
+class CallbackTelemetry {
+public:
+	/// Default number of records buffered, a few seconds of callbacks at small buffer sizes
+	static constexpr size_t DEFAULT_CAPACITY = 4096;
+
+private:
+	dsp::RingBuffer<CallbackRecord> records;
+	std::atomic<uint64_t>           num_dropped = 0;
+
+public:
+	explicit CallbackTelemetry(const size_t capacity = DEFAULT_CAPACITY);
+
+	/**
+	 * @brief  Audio thread only. Real-time safe
+	 * @return Whether there was room for the record
+	 */
+	bool push(const CallbackRecord& record);
+
+	/**
+	 * @brief  Control thread only. Copy up to destination.size() records out of the channel
+	 * @return Number of records read
+	 */
+	size_t read(std::span<CallbackRecord> destination);
+
+	/**
+	 * @return Number of records dropped because the channel was full
+	 */
+	uint64_t dropped_count() const;
+};
+
+/**
+ * @brief Histogram of num_buckets buckets of equal width starting at 0. Values past
+ * the last bucket are counted in the last bucket, and negative values in the first.
+ */
+class Histogram {
+private:
+	double                bucket_width;
+	std::vector<uint64_t> buckets;
+	uint64_t              num_values = 0;
+	double                sum        = 0.0;
+	double                max_value  = 0.0;
+
+public:
+	Histogram(const double bucket_width, const size_t num_buckets);
+
+	void add(const double value);
+	void reset();
+
+	uint64_t count() const;
+	double mean() const;
+	double max() const;
+	/**
+	 * @brief  Approximate percentile
+	 * @param  percentile Percentile in [0, 100]
+	 * @return Upper edge of the bucket that contains the percentile, or 0 when empty
+	 */
+	double percentile(const double percentile) const;
+	double get_bucket_width() const;
+	const std::vector<uint64_t>& get_buckets() const;
+};
+
+/**
+ * @brief Control thread aggregation of CallbackRecords, e.g. to report how close a
+ * stream runs to its deadline and to alert before it glitches
+ */
+class CallbackStats {
+public:
+	/// Time spent in the callback in microseconds, in 10 microsecond buckets up to 20 ms
+	Histogram cpu_time_us = Histogram(10.0, 2000);
+	/// Time spent in the callback as a fraction of the buffer period, in 1% buckets up to 200%
+	Histogram load        = Histogram(0.01, 200);
+
+	uint64_t  num_callbacks         = 0;
+	uint64_t  num_output_underflows = 0;
+	uint64_t  num_output_overflows  = 0;
+	/// Least time in nanoseconds between a callback finishing and its output reaching the DAC
+	int64_t   min_slack_ns          = std::numeric_limits<int64_t>::max();
+	/// sample_index of the latest record
+	size_t    sample_index          = 0;
+
+	void add(const CallbackRecord& record);
+
+	/**
+	 * @brief  Add every record that is waiting in the telemetry channel
+	 * @return Number of records added
+	 */
+	size_t collect(CallbackTelemetry& telemetry);
+
+	void reset();
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstddef>
+
+/**
+ * @brief Work-stealing pool of worker threads for offline processing. Never use it
+ * from the audio thread.
+ *
+ * Every worker has its own deque of tasks. A worker takes the newest task of its
+ * own deque and, when it runs out, steals the oldest task of another worker, so
+ * long and short tasks balance across the workers by themselves. Tasks submitted
+ * from a worker go to that worker's deque. Tasks must not throw.
+ */
+class ThreadPool {
+public:
+	using task_type = std::function<void()>;
+
+private:
+	struct Worker {
+		std::mutex            mutex;
+		std::deque<task_type> tasks;
+	};
+
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::vector<std::thread>             threads;
+	/// Guards sleeping and waking, together with num_queued
+	std::mutex                           mutex;
+	std::condition_variable              work_cv;
+	std::condition_variable              idle_cv;
+	/// Number of tasks in the deques
+	std::atomic<size_t>                  num_queued  = 0;
+	/// Number of tasks that have been submitted but not finished
+	std::atomic<size_t>                  num_pending = 0;
+	/// Worker whose deque the next task from outside the pool goes to
+	std::atomic<size_t>                  next_worker = 0;
+	bool                                 stopping    = false;
+
+public:
+	/**
+	 * @param num_threads Number of worker threads. 0 uses one per hardware thread
+	 */
+	explicit ThreadPool(const size_t num_threads = 0);
+
+	ThreadPool(const ThreadPool& rhs) = delete;
+	ThreadPool& operator=(const ThreadPool& rhs) = delete;
+
+	/**
+	 * @brief Finish every submitted task and join the workers
+	 */
+	~ThreadPool();
+
+	size_t num_threads() const;
+
+	void submit(task_type task);
+
+	/**
+	 * @brief Block until every submitted task, including tasks submitted by tasks, has
+	 * finished. Must not be called from a task
+	 */
+	void wait();
+
+	/**
+	 * @brief Run fn(i) for every i in [0, count) across the workers and wait for all of
+	 * them. Must not be called from a task
+	 */
+	void parallel_for(const size_t count, const std::function<void(size_t)>& fn);
+
+private:
+	void worker_loop(const size_t index);
+	bool try_pop(const size_t index, task_type& task);
+	void run(task_type& task);
+};
@@ -0,0 +1,256 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "ring_buffer.hpp"
+
+/**
+ * Hot-path tracing, compiled in only when STAC_AUDIO_ENABLE_TRACING is defined,
+ * e.g. by configuring with -DSTAC_AUDIO_ENABLE_TRACING=ON. Otherwise every
+ * STAC_TRACE_* macro expands to nothing and its arguments are not evaluated.
+ *
+ * STAC_TRACE_SCOPE("name") or STAC_TRACE_SCOPE("name", arg) times the rest of the
+ * enclosing scope. STAC_TRACE_COUNTER("name", value) records a value.
+ * STAC_TRACE_THREAD("name") names the calling thread in the trace.
+ * STAC_TRACE_RESERVE_THREADS(n) allocates buffers for n threads ahead of time, e.g.
+ * before starting a thread that must not allocate. Names must be string literals,
+ * since only the pointer is recorded.
+ */
+#ifdef STAC_AUDIO_ENABLE_TRACING
+#define STAC_TRACE_CONCAT_IMPL(a, b) a##b
+#define STAC_TRACE_CONCAT(a, b) STAC_TRACE_CONCAT_IMPL(a, b)
+#define STAC_TRACE_SCOPE(...) const dsp::trace::ScopedTrace STAC_TRACE_CONCAT(stac_trace_scope_, __LINE__)(__VA_ARGS__)
+#define STAC_TRACE_COUNTER(name, value) dsp::trace::Tracer::instance().counter(name, static_cast<int64_t>(value))
+#define STAC_TRACE_THREAD(name) dsp::trace::Tracer::instance().register_thread(name)
+#define STAC_TRACE_RESERVE_THREADS(num_threads) dsp::trace::Tracer::instance().reserve(num_threads)
+#else
+#define STAC_TRACE_SCOPE(...) ((void)0)
+#define STAC_TRACE_COUNTER(name, value) ((void)0)
+#define STAC_TRACE_THREAD(name) ((void)0)
+#define STAC_TRACE_RESERVE_THREADS(num_threads) ((void)0)
+#endif
+
+namespace dsp::trace {
+enum class EventType : uint8_t {
+	/// A span of time, e.g. one stage of the audio callback
+	SCOPE,
+	/// A value at a point in time
+	COUNTER
+};
+
+/**
+ * @brief One event recorded by a thread
+ */
+struct TraceEvent {
+	/// String literal naming the event
+	const char* name        = nullptr;
+	/// Nanoseconds since the tracer was created
+	uint64_t    start_ns    = 0;
+	uint64_t    duration_ns = 0;
+	/// Value of a counter, or argument of a scope, e.g. a block size. NO_ARG for none
+	int64_t     value       = 0;
+	EventType   type        = EventType::SCOPE;
+};
+
+/// Value of a scope that has no argument
+inline constexpr int64_t NO_ARG = INT64_MIN;
+
+/**
+ * @brief Events of one thread. The thread is the only producer, and the tracer
+ * the only consumer, so recording never locks or allocates. Once its thread has
+ * exited and its events have been collected, the buffer is reused by a new thread.
+ */
+struct ThreadTrace {
+	dsp::RingBuffer<TraceEvent> events;
+	/// Thread id in the exported trace. Unique to each thread that has used the buffer
+	uint32_t                    id   = 0;
+	/// String literal naming the thread
+	const char*                 name = nullptr;
+	std::atomic<uint64_t>       num_dropped = 0;
+
+	explicit ThreadTrace(const size_t capacity) :
+		events(capacity)
+	{ }
+};
+
+/**
+ * @brief Process-wide collector of trace events.
+ *
+ * Every thread records into its own lock-free ring buffer, which is taken from a
+ * table of MAX_THREADS slots the first time the thread records an event. A slot is
+ * handed back once its thread has exited and its remaining events have been
+ * collected, so short-lived threads, e.g. the workers of a ThreadPool, do not use
+ * up the table. The buffer of a slot is kept for the next thread, so only the first
+ * thread to use a slot allocates. To keep that allocation off a real-time thread,
+ * call STAC_TRACE_RESERVE_THREADS before starting it, as AudioEngine::start does.
+ *
+ * A single control thread calls collect to drain the buffers, and write_chrome_trace
+ * to export what it collected as Chrome trace event JSON, which chrome://tracing
+ * and https://ui.perfetto.dev open. When a thread records faster than the buffers
+ * are collected, its newest events are dropped and counted.
+ */
+class Tracer {
+public:
+	/// Maximum number of threads that may record events at once
+	static constexpr size_t MAX_THREADS      = 64;
+	/// Events buffered per thread between two collects
+	static constexpr size_t DEFAULT_CAPACITY = 1 << 15;
+
+private:
+	using clock = std::chrono::steady_clock;
+
+	enum class SlotState : uint8_t {
+		/// Not used by any thread. May or may not have a buffer
+		FREE,
+		/// Being set up by a thread, and not visible to the consumer yet
+		CLAIMED,
+		/// Recording events of a running thread
+		ACTIVE,
+		/// Its thread has exited. Handed back once its events have been collected
+		RELEASED
+	};
+
+	struct Slot {
+		std::atomic<SlotState>    state = SlotState::FREE;
+		/// Allocated by the first thread that claims the slot and kept until the tracer is destroyed
+		std::atomic<ThreadTrace*> trace = nullptr;
+	};
+
+	clock::time_point                                   start_time = clock::now();
+	std::array<Slot, MAX_THREADS>                       slots;
+	std::atomic<uint32_t>                               next_thread_id = 1;
+	/// Events recorded by threads that found every slot taken
+	std::atomic<uint64_t>                               num_unregistered_dropped = 0;
+	/// Events dropped by threads whose slots have been handed back
+	std::atomic<uint64_t>                               num_released_dropped = 0;
+	/// Guards the collected events, the thread names, and the consumer side of the buffers
+	mutable std::mutex                                  collect_mutex;
+	std::vector<std::pair<uint32_t, TraceEvent>>        collected;
+	/// Id and name of every thread that has recorded events
+	std::vector<std::pair<uint32_t, const char*>>       thread_names;
+	/// Consumer only. Id of the thread of each slot whose name is in thread_names
+	std::array<uint32_t, MAX_THREADS>                   named_ids = { };
+
+	Tracer() = default;
+
+public:
+	Tracer(const Tracer& rhs) = delete;
+	Tracer& operator=(const Tracer& rhs) = delete;
+
+	~Tracer();
+
+	static Tracer& instance() {
+		static Tracer tracer;
+
+		return tracer;
+	}
+
+	/**
+	 * @brief  Take a slot for the calling thread if it does not have one yet. Does not
+	 * allocate when a free slot already has a buffer, e.g. one made by reserve
+	 * @param  name String literal naming the thread in the trace. Ignored if the thread
+	 * already has a slot
+	 * @return Buffer of the thread, or nullptr if every slot is taken
+	 */
+	ThreadTrace* register_thread(const char* name = "thread");
+
+	/**
+	 * @brief Allocate the buffers of free slots until at least num_threads free slots
+	 * have one, so that threads registering later do not allocate
+	 */
+	void reserve(const size_t num_threads);
+
+	/**
+	 * @return Real-time safe. Nanoseconds since the tracer was created
+	 */
+	uint64_t now_ns() const {
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			clock::now() - this->start_time).count());
+	}
+
+	/**
+	 * @brief Real-time safe once the calling thread has a buffer. Record an event of the calling thread
+	 */
+	void record(const TraceEvent& event);
+
+	void counter(const char* name, const int64_t value) {
+		this->record({ name, this->now_ns(), 0, value, EventType::COUNTER });
+	}
+
+	/**
+	 * @brief  Move the events of every thread out of their buffers, and hand back the
+	 * slots of threads that have exited
+	 * @return Number of events collected
+	 */
+	size_t collect();
+
+	/**
+	 * @brief Discard every collected event
+	 */
+	void clear();
+
+	/**
+	 * @return Number of events dropped because a buffer was full or every slot was taken
+	 */
+	uint64_t dropped_count() const;
+
+	/**
+	 * @brief Collect, then write every collected event as Chrome trace event JSON
+	 */
+	void write_chrome_trace(std::ostream& os);
+	/**
+	 * @return Whether the file was written
+	 */
+	bool write_chrome_trace(const std::string& file_path);
+
+private:
+	/**
+	 * @brief  Claim a free slot for the calling thread, preferring slots that already have a buffer
+	 * @return Buffer of the slot, or nullptr if every slot is taken
+	 */
+	ThreadTrace* claim_slot(const char* name);
+	/**
+	 * @brief Called when a thread that has a slot exits
+	 */
+	void release(const size_t slot_index);
+	size_t collect_locked();
+
+	friend struct ThreadTraceOwner;
+};
+
+/**
+ * @brief Records the time from its construction to its destruction as a scope of
+ * the calling thread. Use through STAC_TRACE_SCOPE
+ */
+class ScopedTrace {
+private:
+	const char* name;
+	int64_t     arg;
+	uint64_t    start_ns;
+
+public:
+	explicit ScopedTrace(const char* name, const int64_t arg = NO_ARG) :
+		name(name),
+		arg(arg),
+		start_ns(Tracer::instance().now_ns())
+	{ }
+
+	ScopedTrace(const ScopedTrace& rhs) = delete;
+	ScopedTrace& operator=(const ScopedTrace& rhs) = delete;
+
+	~ScopedTrace() {
+		Tracer& tracer = Tracer::instance();
+
+		tracer.record({ this->name, this->start_ns, tracer.now_ns() - this->start_ns, this->arg, EventType::SCOPE });
+	}
+};
+} // namespace dsp::trace
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "aligned_allocator.hpp"
+
+namespace dsp {
+/**
+ * @brief Lock-free single writer, single reader slot for the latest value of a
+ * parameter, e.g. filter coefficients computed by the UI thread for the audio
+ * thread. Neither side ever blocks or allocates, and the writer may publish
+ * faster than the reader reads, in which case only the latest value is seen.
+ */
+template<typename _value_t>
+class TripleBuffer {
+private:
+	struct alignas(DEFAULT_BUFFER_ALIGNMENT) Slot {
+		_value_t value = _value_t();
+	};
+
+	/// Set in middle when the middle slot holds a value the reader has not seen
+	static constexpr uint8_t DIRTY_BIT  = 0x4;
+	static constexpr uint8_t INDEX_MASK = 0x3;
+
+	std::array<Slot, 3> slots;
+	/// Index of the slot that is exchanged between the writer and the reader
+	alignas(DEFAULT_BUFFER_ALIGNMENT) std::atomic<uint8_t> middle = 1;
+	/// Writer only. Index of the slot being written
+	alignas(DEFAULT_BUFFER_ALIGNMENT) uint8_t              back   = 2;
+	/// Reader only. Index of the slot being read
+	alignas(DEFAULT_BUFFER_ALIGNMENT) uint8_t              front  = 0;
+
+public:
+	explicit TripleBuffer(const _value_t& initial = _value_t()) {
+		for (Slot& slot : this->slots) {
+			slot.value = initial;
+		}
+	}
+
+	TripleBuffer(const TripleBuffer& rhs) = delete;
+	TripleBuffer& operator=(const TripleBuffer& rhs) = delete;
+
+	/**
+	 * @brief  Writer only. Slot that may be written to before calling publish
+	 */
+	_value_t& write_buffer() {
+		return this->slots[this->back].value;
+	}
+
+	/**
+	 * @brief Writer only. Make the write buffer the latest value
+	 */
+	void publish() {
+		const uint8_t old_middle = this->middle.exchange(this->back | DIRTY_BIT, std::memory_order_acq_rel);
+
+		this->back = old_middle & INDEX_MASK;
+	}
+
+	/**
+	 * @brief Writer only. Copy a value into the write buffer and publish it
+	 */
+	void write(const _value_t& value) {
+		this->write_buffer() = value;
+		this->publish();
+	}
+
+	/**
+	 * @brief  Reader only. Take the latest published value, if there is a new one
+	 * @return Whether a new value was published since the last update
+	 */
+	bool update() {
+		if ((this->middle.load(std::memory_order_relaxed) & DIRTY_BIT) == 0) {
+			return false;
+		}
+
+		const uint8_t old_middle = this->middle.exchange(this->front, std::memory_order_acq_rel);
+
+		this->front = old_middle & INDEX_MASK;
+
+		return true;
+	}
+
+	/**
+	 * @brief  Reader only. Latest value taken by update
+	 */
+	const _value_t& read() const {
+		return this->slots[this->front].value;
+	}
+};
+} // namespace dsp
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <span>
+#include <numbers>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace dsp {
+enum class WindowType : uint8_t {
+	RECTANGULAR,
+	HANN,
+	HAMMING,
+	BLACKMAN
+};
+
+/**
+ * @brief Fill a buffer with a periodic window, which is the form that overlaps
+ * evenly when frames are hopped by a fraction of the window length
+ * @param window_type Shape of the window
+ * @param window Buffer to fill. Its size is the length of the window
+ */
+template<typename _sample_t>
+void fill_window(const WindowType window_type, const std::span<_sample_t> window) {
+	const double length = static_cast<double>(window.size());
+
+	for (size_t i = 0; i < window.size(); i++) {
+		const double phase = 2.0 * std::numbers::pi * static_cast<double>(i) / length;
+		double value = 1.0;
+
+		switch (window_type) {
+			case WindowType::RECTANGULAR:
+				value = 1.0;
+				break;
+			case WindowType::HANN:
+				value = 0.5 - 0.5 * std::cos(phase);
+				break;
+			case WindowType::HAMMING:
+				value = 0.54 - 0.46 * std::cos(phase);
+				break;
+			case WindowType::BLACKMAN:
+				value = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+				break;
+		}
+
+		window[i] = static_cast<_sample_t>(value);
+	}
+}
+} // namespace dsp
@@ -0,0 +1,302 @@
+#include "audio_backend.hpp"
+
+#include <chrono>
+
+PortAudioBackend::~PortAudioBackend() {
+	this->close();
+}
+
+bool PortAudioBackend::open(const AudioStreamConfig& config, PaStreamCallback* callback,
+                            PaStreamFinishedCallback* finished_callback, void* user_data) {
+	this->close();
+
+	if (!this->check(Pa_Initialize())) {
+		return false;
+	}
+
+	this->initialized = true;
+
+	PaStreamParameters stream_params;
+
+	stream_params.device = (config.device == paNoDevice) ? Pa_GetDefaultOutputDevice() : config.device;
+
+	const PaDeviceInfo* device_info = Pa_GetDeviceInfo(stream_params.device);
+
+	if (device_info == nullptr) {
+		this->close();
+		return false;
+	}
+
+	stream_params.suggestedLatency = (config.suggested_latency > 0.0) ? config.suggested_latency :
+	                                 device_info->defaultLowOutputLatency;
+	stream_params.channelCount = static_cast<int>(config.num_channels);
+	stream_params.sampleFormat = paFloat32;
+	stream_params.hostApiSpecificStreamInfo = nullptr;
+
+	const unsigned long frames_per_buffer = (config.frames_per_buffer == 0) ? paFramesPerBufferUnspecified :
+	                                        static_cast<unsigned long>(config.frames_per_buffer);
+
+	if (!this->check(Pa_OpenStream(&this->stream, nullptr, &stream_params, config.sample_rate,
+	                               frames_per_buffer, paClipOff, callback, user_data))) {
+		this->stream = nullptr;
+		this->close();
+		return false;
+	}
+
+	if (finished_callback != nullptr && !this->check(Pa_SetStreamFinishedCallback(this->stream, finished_callback))) {
+		this->close();
+		return false;
+	}
+
+	return true;
+}
+
+bool PortAudioBackend::start() {
+	return this->stream != nullptr && this->check(Pa_StartStream(this->stream));
+}
+
+void PortAudioBackend::stop() {
+	if (this->is_active()) {
+		this->check(Pa_StopStream(this->stream));
+	}
+}
+
+void PortAudioBackend::close() {
+	if (this->stream != nullptr) {
+		// aborts the stream first if it is still running
+		this->check(Pa_CloseStream(this->stream));
+		this->stream = nullptr;
+	}
+
+	if (this->initialized) {
+		this->check(Pa_Terminate());
+		this->initialized = false;
+	}
+}
+
+bool PortAudioBackend::is_active() const {
+	return this->stream != nullptr && Pa_IsStreamActive(this->stream) == 1;
+}
+
+PaError PortAudioBackend::get_last_error() const {
+	return this->last_error;
+}
+
+bool PortAudioBackend::check(const PaError err) {
+	if (err != paNoError) {
+		this->last_error = err;
+		return false;
+	}
+
+	return true;
+}
+
+NullBackend::NullBackend(const bool real_time) :
+	real_time(real_time)
+{ }
+
+NullBackend::~NullBackend() {
+	this->close();
+}
+
+bool NullBackend::open(const AudioStreamConfig& config, PaStreamCallback* callback,
+                       PaStreamFinishedCallback* finished_callback, void* user_data) {
+	// not this->close(), which would close the file of a FileSinkBackend that is being opened
+	NullBackend::close();
+
+	if (callback == nullptr || config.sample_rate == 0 || config.num_channels == 0) {
+		return false;
+	}
+
+	this->config = config;
+
+	if (this->config.frames_per_buffer == 0) {
+		this->config.frames_per_buffer = dsp::FRAMES_PER_BUFFER;
+	}
+
+	this->callback = callback;
+	this->finished_callback = finished_callback;
+	this->user_data = user_data;
+	this->buffer.assign(this->config.frames_per_buffer * this->config.num_channels, dsp::SAMPLE_SILENCE);
+	this->num_buffers.store(0);
+	this->num_underflows.store(0);
+	this->opened = true;
+
+	return true;
+}
+
+bool NullBackend::start() {
+	if (!this->opened || this->active.load()) {
+		return false;
+	}
+
+	// the thread of a stream that has finished by itself
+	if (this->thread.joinable()) {
+		this->thread.join();
+	}
+
+	this->running.store(true);
+	this->active.store(true);
+	this->thread = std::thread(&NullBackend::run, this);
+
+	return true;
+}
+
+void NullBackend::stop() {
+	this->running.store(false);
+
+	if (this->thread.joinable()) {
+		this->thread.join();
+	}
+}
+
+void NullBackend::close() {
+	this->stop();
+	this->opened = false;
+}
+
+bool NullBackend::is_active() const {
+	return this->active.load();
+}
+
+PaError NullBackend::get_last_error() const {
+	return paNoError;
+}
+
+bool NullBackend::is_real_time() const {
+	return this->real_time;
+}
+
+uint64_t NullBackend::buffer_count() const {
+	return this->num_buffers.load(std::memory_order_relaxed);
+}
+
+uint64_t NullBackend::underflow_count() const {
+	return this->num_underflows.load(std::memory_order_relaxed);
+}
+
+bool NullBackend::deliver(const float* const samples, const size_t num_frames) {
+	(void)samples;
+	(void)num_frames;
+
+	return true;
+}
+
+void NullBackend::run() {
+	using clock = std::chrono::steady_clock;
+
+	const size_t frames_per_buffer = this->config.frames_per_buffer;
+	const std::chrono::duration<double> period(static_cast<double>(frames_per_buffer) /
+	                                           static_cast<double>(this->config.sample_rate));
+	const clock::time_point start_time = clock::now();
+	clock::time_point deadline = start_time;
+	PaStreamCallbackFlags status_flags = 0;
+
+	while (this->running.load(std::memory_order_acquire)) {
+		const double current_time = std::chrono::duration<double>(clock::now() - start_time).count();
+		// a sound card would start playing the buffer one period from now
+		const PaStreamCallbackTimeInfo time_info = { 0.0, current_time, current_time + period.count() };
+		const int32_t ret = this->callback(nullptr, this->buffer.data(), frames_per_buffer, &time_info,
+		                                   status_flags, this->user_data);
+
+		if (ret == paAbort) {
+			break;
+		}
+
+		if (!this->deliver(this->buffer.data(), frames_per_buffer)) {
+			break;
+		}
+
+		this->num_buffers.fetch_add(1, std::memory_order_relaxed);
+
+		if (ret == paComplete) {
+			break;
+		}
+
+		status_flags = 0;
+
+		if (this->real_time) {
+			deadline += std::chrono::duration_cast<clock::duration>(period);
+
+			if (clock::now() > deadline) {
+				// the buffer would have played late, so start over from now
+				status_flags = paOutputUnderflow;
+				deadline = clock::now();
+				this->num_underflows.fetch_add(1, std::memory_order_relaxed);
+			} else {
+				std::this_thread::sleep_until(deadline);
+			}
+		}
+	}
+
+	this->active.store(false);
+
+	if (this->finished_callback != nullptr) {
+		this->finished_callback(this->user_data);
+	}
+}
+
+FileSinkBackend::FileSinkBackend(const std::string& file_path, const bool real_time, const int32_t format) :
+	NullBackend(real_time),
+	file_path(file_path),
+	format(format)
+{ }
+
+FileSinkBackend::~FileSinkBackend() {
+	this->close();
+}
+
+bool FileSinkBackend::open(const AudioStreamConfig& config, PaStreamCallback* callback,
+                           PaStreamFinishedCallback* finished_callback, void* user_data) {
+	this->close();
+	this->write_failed.store(false);
+
+	SF_INFO sf_info = { };
+
+	sf_info.samplerate = static_cast<int>(config.sample_rate);
+	sf_info.channels = static_cast<int>(config.num_channels);
+	sf_info.format = this->format;
+
+	if (sf_format_check(&sf_info) == 0) {
+		return false;
+	}
+
+	this->sf = sf_open(this->file_path.c_str(), SFM_WRITE, &sf_info);
+
+	if (this->sf == nullptr) {
+		return false;
+	}
+
+	if (!NullBackend::open(config, callback, finished_callback, user_data)) {
+		this->close();
+		return false;
+	}
+
+	return true;
+}
+
+void FileSinkBackend::close() {
+	NullBackend::close();
+
+	if (this->sf != nullptr) {
+		// closing flushes the last of the file, which may fail as well
+		if (sf_close(this->sf) != 0) {
+			this->write_failed.store(true);
+		}
+
+		this->sf = nullptr;
+	}
+}
+
+PaError FileSinkBackend::get_last_error() const {
+	return this->write_failed.load() ? paInternalError : paNoError;
+}
+
+bool FileSinkBackend::deliver(const float* const samples, const size_t num_frames) {
+	if (sf_writef_float(this->sf, samples, static_cast<sf_count_t>(num_frames)) != static_cast<sf_count_t>(num_frames)) {
+		this->write_failed.store(true);
+		return false;
+	}
+
+	return true;
+}
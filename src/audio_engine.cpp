@@ -0,0 +1,439 @@
+#include "audio_engine.hpp"
+
+#include <algorithm>
+
+#include "block_ops.hpp"
+#include "dsp_utils.hpp"
+#include "tracing.hpp"
+
+AudioEngine::AudioEngine() :
+	backend(std::make_unique<PortAudioBackend>())
+{ }
+
+AudioEngine::AudioEngine(std::unique_ptr<AudioBackend> backend) :
+	backend(std::move(backend))
+{ }
+
+AudioEngine::~AudioEngine() {
+	this->close();
+}
+
+bool AudioEngine::open(const dsp::PlanarSignal<dsp::sample_t>* signal, const Config& config) {
+	this->close();
+
+	if (signal == nullptr || signal->num_frames() == 0) {
+		return false;
+	}
+
+	this->atd.signal = signal;
+	this->atd.stream = nullptr;
+	this->atd.view = dsp::SignalView<dsp::sample_t>();
+
+	return this->open_stream(signal->sample_rate, config);
+}
+
+bool AudioEngine::open(StreamingSource* source, const Config& config) {
+	this->close();
+
+	if (source == nullptr || !source->is_open() || source->num_frames() == 0) {
+		return false;
+	}
+
+	this->atd.signal = nullptr;
+	this->atd.stream = source;
+	this->atd.view = dsp::SignalView<dsp::sample_t>();
+
+	return this->open_stream(source->sample_rate(), config);
+}
+
+bool AudioEngine::open(const dsp::SignalView<dsp::sample_t>& view, const Config& config) {
+	this->close();
+
+	if (view.empty() || view.num_channels == 0 || view.samples == nullptr) {
+		return false;
+	}
+
+	this->atd.signal = nullptr;
+	this->atd.stream = nullptr;
+	this->atd.view = view;
+
+	return this->open_stream(view.sample_rate, config);
+}
+
+bool AudioEngine::open_stream(const dsp::sample_rate_t source_sample_rate, const Config& config) {
+	this->config = config;
+
+	if (this->config.sample_rate == 0) {
+		this->config.sample_rate = source_sample_rate;
+	}
+
+	AudioStreamConfig stream_config;
+
+	stream_config.sample_rate = this->config.sample_rate;
+	stream_config.frames_per_buffer = this->config.frames_per_buffer;
+	stream_config.num_channels = this->config.num_channels;
+	stream_config.device = this->config.device;
+	stream_config.suggested_latency = this->config.suggested_latency;
+
+	this->atd.state = AudioThreadState::PAUSED;
+	this->atd.sample_index = 0;
+	this->atd.effects = &this->effects;
+
+	if (!this->backend->open(stream_config, &AudioEngine::stream_callback, &AudioEngine::stream_finished_callback, this)) {
+		this->close();
+		return false;
+	}
+
+	this->opened = true;
+
+	return true;
+}
+
+bool AudioEngine::start() {
+	if (!this->opened) {
+		return false;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(this->finished_mutex);
+		this->finished = false;
+	}
+
+	// so that the first callback does not allocate the audio thread's trace buffer
+	STAC_TRACE_RESERVE_THREADS(1);
+
+	if (!this->backend->start()) {
+		std::lock_guard<std::mutex> lock(this->finished_mutex);
+		this->finished = true;
+
+		return false;
+	}
+
+	return true;
+}
+
+void AudioEngine::stop() {
+	if (this->opened) {
+		this->backend->stop();
+	}
+}
+
+void AudioEngine::close() {
+	// aborts the stream first if it is still running
+	this->backend->close();
+	this->opened = false;
+
+	{
+		std::lock_guard<std::mutex> lock(this->finished_mutex);
+		this->finished = true;
+	}
+
+	this->finished_cv.notify_all();
+
+	this->atd.state = AudioThreadState::IDLE;
+	this->atd.signal = nullptr;
+	this->atd.stream = nullptr;
+	this->atd.view = dsp::SignalView<dsp::sample_t>();
+}
+
+void AudioEngine::wait() {
+	std::unique_lock<std::mutex> lock(this->finished_mutex);
+
+	this->finished_cv.wait(lock, [this] { return this->finished; });
+}
+
+bool AudioEngine::wait_for(const std::chrono::milliseconds timeout) {
+	std::unique_lock<std::mutex> lock(this->finished_mutex);
+
+	return this->finished_cv.wait_for(lock, timeout, [this] { return this->finished; });
+}
+
+bool AudioEngine::send(const lfmq::Message& msg) {
+	return this->message_queue.push(msg);
+}
+
+bool AudioEngine::is_open() const {
+	return this->opened;
+}
+
+bool AudioEngine::is_active() const {
+	return this->opened && this->backend->is_active();
+}
+
+dsp::sample_rate_t AudioEngine::sample_rate() const {
+	return this->config.sample_rate;
+}
+
+const AudioEngine::Config& AudioEngine::get_config() const {
+	return this->config;
+}
+
+PaError AudioEngine::get_last_error() const {
+	return this->backend->get_last_error();
+}
+
+AudioBackend& AudioEngine::get_backend() {
+	return *this->backend;
+}
+
+EffectChainHost<dsp::sample_t>& AudioEngine::get_effects() {
+	return this->effects;
+}
+
+CallbackTelemetry& AudioEngine::get_telemetry() {
+	return this->telemetry;
+}
+
+int32_t AudioEngine::stream_callback(const void* input_buffer, void* output_buffer,
+		unsigned long frames_per_buffer, const PaStreamCallbackTimeInfo* time_info,
+		PaStreamCallbackFlags status_flags, void* user_data) {
+	(void)input_buffer;
+
+	if (user_data == nullptr || output_buffer == nullptr) {
+		return paAbort;
+	}
+
+	AudioEngine& engine = *static_cast<AudioEngine*>(user_data);
+
+	STAC_TRACE_THREAD("audio");
+	STAC_TRACE_SCOPE("callback", frames_per_buffer);
+	STAC_TRACE_COUNTER("status_flags", status_flags);
+
+	if (!engine.config.collect_telemetry) {
+		return engine.process(static_cast<float*>(output_buffer), frames_per_buffer);
+	}
+
+	const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+	const int32_t ret = engine.process(static_cast<float*>(output_buffer), frames_per_buffer);
+	CallbackRecord record;
+
+	record.cpu_time_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - start_time).count());
+	record.buffer_period_ns = static_cast<uint64_t>(frames_per_buffer) * 1000000000ull / engine.config.sample_rate;
+	record.status_flags = status_flags;
+	record.frames_per_buffer = static_cast<uint32_t>(frames_per_buffer);
+	record.sample_index = engine.atd.sample_index;
+
+	if (time_info != nullptr && time_info->outputBufferDacTime > 0.0 && time_info->currentTime > 0.0) {
+		record.time_to_dac_ns = static_cast<int64_t>((time_info->outputBufferDacTime - time_info->currentTime) * 1e9);
+	}
+
+	engine.telemetry.push(record);
+
+	return ret;
+}
+
+void AudioEngine::stream_finished_callback(void* user_data) {
+	AudioEngine& engine = *static_cast<AudioEngine*>(user_data);
+
+	{
+		std::lock_guard<std::mutex> lock(engine.finished_mutex);
+		engine.finished = true;
+	}
+
+	engine.finished_cv.notify_all();
+}
+
+int32_t AudioEngine::process(float* const out_buf, const size_t frames_per_buffer) {
+	// nothing on this thread may allocate, lock, or print
+	PaStreamCallbackResult ret = paContinue;
+	AudioThreadData& atd = this->atd;
+	const size_t out_channels = this->config.num_channels;
+
+	this->process_messages();
+
+	switch (atd.state) {
+	case AudioThreadState::PLAYING:
+		// the host may ask for more or fewer frames than the wave holds, so the buffer is filled
+		// one wave-sized block at a time
+		for (size_t offset = 0; offset < frames_per_buffer; offset += atd.wave.size()) {
+			const std::span<dsp::Frame<dsp::sample_t>> block(atd.wave.data(),
+				std::min<size_t>(atd.wave.size(), frames_per_buffer - offset));
+
+			if (atd.stream != nullptr) {
+				STAC_TRACE_SCOPE("read", block.size());
+				// the stream loops the audio itself
+				atd.stream->read(block);
+				atd.sample_index = atd.stream->position();
+			} else if (atd.signal != nullptr) {
+				STAC_TRACE_SCOPE("read", block.size());
+				// mono signals are duplicated into both channels
+				atd.sample_index = dsp::read_wrapped(*atd.signal, atd.sample_index, block);
+			} else {
+				STAC_TRACE_SCOPE("read", block.size());
+				atd.sample_index = dsp::read_wrapped(atd.view, atd.sample_index, block);
+			}
+
+			if (atd.effects != nullptr) {
+				STAC_TRACE_SCOPE("effects", block.size());
+				atd.effects->process(block);
+			}
+
+			{
+				STAC_TRACE_SCOPE("write", block.size());
+				// apply the volume while copying the block into the output buffer
+				dsp::write_interleaved(std::span<const dsp::Frame<dsp::sample_t>>(block),
+					out_buf + offset * out_channels, out_channels, atd.amplitude_scalar);
+			}
+
+			// a file that does not loop is done once its last frame has been written
+			if (atd.stream != nullptr && atd.stream->is_finished()) {
+				const size_t written = offset + block.size();
+
+				std::fill_n(out_buf + written * out_channels, (frames_per_buffer - written) * out_channels,
+					dsp::SAMPLE_SILENCE);
+				atd.state = AudioThreadState::IDLE;
+
+				return paComplete;
+			}
+		}
+
+		break;
+	case AudioThreadState::IDLE:
+		ret = paComplete;
+		[[fallthrough]];
+	case AudioThreadState::PAUSED:
+	case AudioThreadState::STARTING:
+		std::fill_n(out_buf, frames_per_buffer * out_channels, dsp::SAMPLE_SILENCE);
+		break;
+	}
+
+	return ret;
+}
+
+size_t AudioEngine::process_messages() {
+	using clock = std::chrono::steady_clock;
+
+	STAC_TRACE_SCOPE("messages");
+
+	const size_t max_messages = this->config.max_messages_per_callback;
+	const std::chrono::microseconds time_budget = this->config.message_time_budget;
+	const clock::time_point start_time = (time_budget.count() > 0) ? clock::now() : clock::time_point();
+	lfmq::Message msg;
+	// run of messages of the same type that has not been performed yet
+	lfmq::Message pending;
+	size_t num_pending = 0;
+	size_t num_messages_processed = 0;
+
+	while ((max_messages == 0 || num_messages_processed < max_messages) && this->message_queue.pop(&msg)) {
+		const lfmq::MessageType type = msg.get_metadata().get_type();
+
+		num_messages_processed++;
+
+		if (num_pending > 0 && type != pending.get_metadata().get_type()) {
+			this->process_coalesced(pending, num_pending);
+			num_pending = 0;
+		}
+
+		pending = msg;
+		num_pending++;
+
+		// leave anything sent after a stop for the next stream
+		if (type == lfmq::MessageType::STOP) {
+			break;
+		}
+
+		if (time_budget.count() > 0 && clock::now() - start_time >= time_budget) {
+			break;
+		}
+	}
+
+	if (num_pending > 0) {
+		this->process_coalesced(pending, num_pending);
+	}
+
+	return num_messages_processed;
+}
+
+bool AudioEngine::process_coalesced(const lfmq::Message& msg, const size_t num_repeats) {
+	switch (msg.get_metadata().get_type()) {
+	case lfmq::MessageType::PAUSE:
+	case lfmq::MessageType::VOLUME:
+		// an even number of toggles leaves the state as it was
+		if (num_repeats % 2 == 0) {
+			return true;
+		}
+
+		return this->process_message(msg);
+	default:
+		// the last message of the run supersedes the others, e.g. the last seek
+		return this->process_message(msg);
+	}
+}
+
+bool AudioEngine::process_message(const lfmq::Message& msg) {
+	bool successfully_processed;
+
+	switch (msg.get_metadata().get_type()) {
+	case lfmq::MessageType::PLAY_AT:
+		successfully_processed = this->process_play_message(msg.get_payload<dsp::time_ms_t>());
+		break;
+	case lfmq::MessageType::PAUSE:
+		successfully_processed = this->process_pause_message();
+		break;
+	case lfmq::MessageType::VOLUME:
+		successfully_processed = this->process_volume_message();
+		break;
+	case lfmq::MessageType::STOP:
+		successfully_processed = this->process_stop_message();
+		break;
+	default:
+		successfully_processed = false;
+		break;
+	}
+
+	return successfully_processed;
+}
+
+bool AudioEngine::process_play_message(const dsp::time_ms_t time) {
+	if (this->atd.stream != nullptr) {
+		const size_t sample_index = dsp::utils::sample_index_from_time(this->atd.stream->sample_rate(), time);
+
+		if (!this->atd.stream->seek(sample_index)) {
+			return false;
+		}
+
+		this->atd.state = AudioThreadState::PLAYING;
+		this->atd.sample_index = sample_index;
+
+		return true;
+	}
+
+	const dsp::sample_rate_t sample_rate = (this->atd.signal != nullptr) ? this->atd.signal->sample_rate :
+	                                       this->atd.view.sample_rate;
+	const size_t num_frames = (this->atd.signal != nullptr) ? this->atd.signal->num_frames() : this->atd.view.num_frames;
+	const size_t sample_index = dsp::utils::sample_index_from_time(sample_rate, time);
+
+	if (sample_index >= num_frames) {
+		return false;
+	}
+
+	this->atd.state = AudioThreadState::PLAYING;
+	this->atd.sample_index = sample_index;
+
+	return true;
+}
+
+bool AudioEngine::process_pause_message() {
+	if (this->atd.state == AudioThreadState::PAUSED) {
+		this->atd.state = AudioThreadState::PLAYING;
+	} else if (this->atd.state == AudioThreadState::PLAYING) {
+		this->atd.state = AudioThreadState::PAUSED;
+	}
+
+	return true;
+}
+
+bool AudioEngine::process_volume_message() {
+	// toggle the mute status of the audio stream. The volume ramps to the new value
+	// over the next few hundred frames rather than jumping, which would click
+	this->atd.amplitude_scalar.set_target((this->atd.amplitude_scalar.get_target() > 0.5f) ? 0.0f : 1.0f);
+
+	return true;
+}
+
+bool AudioEngine::process_stop_message() {
+	this->atd.state = AudioThreadState::IDLE;
+
+	return true;
+}
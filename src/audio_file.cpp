@@ -0,0 +1,124 @@
+#include "audio_file.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <sndfile.h>
+
+#include "tracing.hpp"
+
+AudioFile::AudioFile(const std::string& file_path) {
+	this->load(file_path);
+}
+
+bool AudioFile::load(const std::string& file_path, const LoadMode mode) {
+	// a failed load leaves the file empty rather than describing the previous file
+	this->mapped_file.close();
+	this->signal = dsp::PlanarSignal<dsp::sample_t>();
+	this->metadata = AudioFileMetadata();
+	this->file_path.clear();
+
+	if (mode == LoadMode::MEMORY_MAPPED && this->mapped_file.open(file_path)) {
+		const dsp::SignalView<dsp::sample_t>& view = this->mapped_file.get_view();
+
+		this->file_path = file_path;
+		this->metadata.format = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+		this->metadata.num_channels = static_cast<uint32_t>(view.num_channels);
+		this->metadata.sample_rate = view.sample_rate;
+		this->metadata.num_frames = view.num_frames;
+
+		return true;
+	}
+
+	SF_INFO sf_info = { };
+	SNDFILE* sf = sf_open(file_path.c_str(), SFM_READ, &sf_info);
+
+	if (sf == nullptr) {
+		return false;
+	}
+
+	// pipes and streams of unknown length report SF_COUNT_MAX frames, which cannot be
+	// allocated up front
+	if (sf_info.channels <= 0 || sf_info.frames < 0 || sf_info.frames == SF_COUNT_MAX
+		|| static_cast<uint64_t>(sf_info.frames) > std::vector<dsp::sample_t>().max_size() / static_cast<uint64_t>(sf_info.channels)) {
+		sf_close(sf);
+		return false;
+	}
+
+	this->file_path = file_path;
+	this->metadata.format = sf_info.format;
+	this->metadata.num_channels = static_cast<uint32_t>(sf_info.channels);
+	this->metadata.sample_rate = static_cast<dsp::sample_rate_t>(sf_info.samplerate);
+	this->metadata.num_frames = static_cast<size_t>(sf_info.frames);
+
+	const size_t num_channels = this->metadata.num_channels;
+	const size_t num_frames = this->metadata.num_frames;
+
+	// size the signal once from the header rather than growing it while reading
+	this->signal = dsp::PlanarSignal<dsp::sample_t>(this->metadata.sample_rate, num_channels, num_frames);
+
+	size_t total_frames_read = 0;
+
+	if (num_channels == 1) {
+		// mono data is already planar, so decode straight into the channel
+		dsp::sample_t* const samples = this->signal.channels[0].data();
+
+		while (total_frames_read < num_frames) {
+			const sf_count_t num_frames_to_read = static_cast<sf_count_t>(std::min(READ_BLOCK_FRAMES, num_frames - total_frames_read));
+			STAC_TRACE_SCOPE("file_read", num_frames_to_read);
+			const sf_count_t curr_frames_read = sf_readf_float(sf, samples + total_frames_read, num_frames_to_read);
+
+			if (curr_frames_read <= 0) {
+				break;
+			}
+
+			total_frames_read += static_cast<size_t>(curr_frames_read);
+		}
+	} else {
+		std::vector<dsp::sample_t> in_buffer(std::min(READ_BLOCK_FRAMES, num_frames) * num_channels);
+
+		while (total_frames_read < num_frames) {
+			const sf_count_t num_frames_to_read = static_cast<sf_count_t>(std::min(READ_BLOCK_FRAMES, num_frames - total_frames_read));
+			STAC_TRACE_SCOPE("file_read", num_frames_to_read);
+			const sf_count_t curr_frames_read = sf_readf_float(sf, in_buffer.data(), num_frames_to_read);
+
+			if (curr_frames_read <= 0) {
+				break;
+			}
+
+			// only the frames that were actually read are deinterleaved into the signal
+			this->signal.write_interleaved(in_buffer.data(), total_frames_read, static_cast<size_t>(curr_frames_read));
+			total_frames_read += static_cast<size_t>(curr_frames_read);
+		}
+	}
+
+	sf_close(sf);
+
+	// the header may overstate the length of a truncated file
+	if (total_frames_read < num_frames) {
+		this->signal.resize(num_channels, total_frames_read);
+		this->metadata.num_frames = total_frames_read;
+	}
+
+	return true;
+}
+
+const AudioFileMetadata& AudioFile::get_metadata() const {
+	return this->metadata;
+}
+
+const dsp::PlanarSignal<dsp::sample_t>& AudioFile::get_signal() const {
+	return this->signal;
+}
+
+bool AudioFile::is_memory_mapped() const {
+	return this->mapped_file.is_open();
+}
+
+const dsp::SignalView<dsp::sample_t>& AudioFile::get_view() const {
+	return this->mapped_file.get_view();
+}
+
+const std::string& AudioFile::get_file_path() const {
+	return this->file_path;
+}
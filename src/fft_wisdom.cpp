@@ -0,0 +1,124 @@
+#include "fft_wisdom.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define STAC_AUDIO_HAS_CPUID 1
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#define STAC_AUDIO_HAS_CPUID 1
+#endif
+
+namespace dsp::fft {
+namespace {
+/**
+ * @return CPU brand string as reported by cpuid, or an empty string if it is unavailable
+ */
+std::string cpu_brand_string() {
+#ifdef STAC_AUDIO_HAS_CPUID
+	static constexpr uint32_t BRAND_STRING_LEAF_BEGIN = 0x80000002;
+	static constexpr uint32_t BRAND_STRING_LEAF_END   = 0x80000004;
+	uint32_t registers[4] = { };
+	char brand[49] = { };
+
+#ifdef _MSC_VER
+	__cpuid(reinterpret_cast<int*>(registers), 0x80000000);
+#else
+	__get_cpuid(0x80000000, &registers[0], &registers[1], &registers[2], &registers[3]);
+#endif
+
+	if (registers[0] < BRAND_STRING_LEAF_END) {
+		return std::string();
+	}
+
+	for (uint32_t leaf = BRAND_STRING_LEAF_BEGIN; leaf <= BRAND_STRING_LEAF_END; leaf++) {
+#ifdef _MSC_VER
+		__cpuid(reinterpret_cast<int*>(registers), static_cast<int>(leaf));
+#else
+		__get_cpuid(leaf, &registers[0], &registers[1], &registers[2], &registers[3]);
+#endif
+		std::memcpy(brand + (leaf - BRAND_STRING_LEAF_BEGIN) * sizeof(registers), registers, sizeof(registers));
+	}
+
+	return std::string(brand);
+#else
+	return std::string();
+#endif
+}
+
+const char* architecture_name() {
+#if defined(__x86_64__) || defined(_M_X64)
+	return "x86_64";
+#elif defined(__i386__) || defined(_M_IX86)
+	return "x86";
+#elif defined(__aarch64__) || defined(_M_ARM64)
+	return "arm64";
+#elif defined(__arm__) || defined(_M_ARM)
+	return "arm";
+#else
+	return "unknown";
+#endif
+}
+} // namespace
+
+std::mutex& planner_mutex() {
+	static std::mutex mutex;
+
+	return mutex;
+}
+
+std::string cpu_identifier() {
+	static const std::string identifier = [] {
+		const std::string brand = cpu_brand_string();
+		std::string id = architecture_name();
+
+		if (!brand.empty()) {
+			id += "_";
+		}
+
+		// collapse anything that is not safe in a file name into a single '-'
+		for (const char c : brand) {
+			if (std::isalnum(static_cast<unsigned char>(c))) {
+				id += c;
+			} else if (id.back() != '-' && id.back() != '_') {
+				id += '-';
+			}
+		}
+
+		while (id.back() == '-') {
+			id.pop_back();
+		}
+
+		return id;
+	}();
+
+	return identifier;
+}
+
+std::filesystem::path default_wisdom_directory() {
+	static constexpr char CACHE_DIR_NAME[] = "stac_audio";
+
+	if (const char* const dir = std::getenv("STAC_AUDIO_WISDOM_DIR"); dir != nullptr && dir[0] != '\0') {
+		return std::filesystem::path(dir);
+	}
+
+#ifdef _WIN32
+	if (const char* const dir = std::getenv("LOCALAPPDATA"); dir != nullptr && dir[0] != '\0') {
+		return std::filesystem::path(dir) / CACHE_DIR_NAME;
+	}
+#else
+	if (const char* const dir = std::getenv("XDG_CACHE_HOME"); dir != nullptr && dir[0] != '\0') {
+		return std::filesystem::path(dir) / CACHE_DIR_NAME;
+	}
+
+	if (const char* const dir = std::getenv("HOME"); dir != nullptr && dir[0] != '\0') {
+		return std::filesystem::path(dir) / ".cache" / CACHE_DIR_NAME;
+	}
+#endif
+
+	return std::filesystem::temp_directory_path() / CACHE_DIR_NAME;
+}
+} // namespace dsp::fft
@@ -0,0 +1,253 @@
+#include "mapped_audio_file.hpp"
+
+#include <bit>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr uint16_t WAVE_FORMAT_IEEE_FLOAT = 0x0003;
+constexpr uint16_t WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+constexpr size_t   RIFF_HEADER_SIZE       = 12;
+constexpr size_t   CHUNK_HEADER_SIZE      = 8;
+/// Offset of the sub-format GUID within a WAVE_FORMAT_EXTENSIBLE fmt chunk
+constexpr size_t   SUB_FORMAT_OFFSET      = 24;
+
+/**
+ * @brief Read a little-endian integer from an unaligned address
+ */
+template<typename _int_t>
+_int_t read_le(const std::byte* const ptr) {
+	_int_t value = 0;
+
+	for (size_t i = 0; i < sizeof(_int_t); i++) {
+		value |= static_cast<_int_t>(static_cast<_int_t>(ptr[i]) << (8 * i));
+	}
+
+	return value;
+}
+
+bool has_id(const std::byte* const ptr, const char (&id)[5]) {
+	return std::memcmp(ptr, id, 4) == 0;
+}
+} // namespace
+
+MappedAudioFile::MappedAudioFile(MappedAudioFile&& rhs) noexcept {
+	*this = std::move(rhs);
+}
+
+MappedAudioFile& MappedAudioFile::operator=(MappedAudioFile&& rhs) noexcept {
+	if (this != &rhs) {
+		this->close();
+
+		this->data = std::exchange(rhs.data, nullptr);
+		this->data_size = std::exchange(rhs.data_size, 0);
+#ifdef _WIN32
+		this->file_handle = std::exchange(rhs.file_handle, nullptr);
+		this->mapping_handle = std::exchange(rhs.mapping_handle, nullptr);
+#endif
+		this->view = std::exchange(rhs.view, dsp::SignalView<dsp::sample_t>());
+	}
+
+	return *this;
+}
+
+MappedAudioFile::~MappedAudioFile() {
+	this->close();
+}
+
+bool MappedAudioFile::open(const std::string& file_path) {
+	// the samples are only usable in place if they are stored exactly as dsp::sample_t
+	if constexpr (std::endian::native != std::endian::little || !std::is_same_v<dsp::sample_t, float>) {
+		return false;
+	}
+
+	this->close();
+
+	if (!this->map(file_path)) {
+		return false;
+	}
+
+	if (!this->parse_header()) {
+		this->close();
+		return false;
+	}
+
+	return true;
+}
+
+void MappedAudioFile::close() {
+	this->unmap();
+	this->view = dsp::SignalView<dsp::sample_t>();
+}
+
+bool MappedAudioFile::is_open() const {
+	return this->data != nullptr;
+}
+
+const dsp::SignalView<dsp::sample_t>& MappedAudioFile::get_view() const {
+	return this->view;
+}
+
+bool MappedAudioFile::parse_header() {
+	if (this->data_size < RIFF_HEADER_SIZE || !has_id(this->data, "RIFF") || !has_id(this->data + 8, "WAVE")) {
+		return false;
+	}
+
+	uint16_t format_tag = 0;
+	uint16_t num_channels = 0;
+	uint32_t sample_rate = 0;
+	uint16_t block_align = 0;
+	uint16_t bits_per_sample = 0;
+	bool found_format = false;
+	size_t offset = RIFF_HEADER_SIZE;
+
+	while (offset + CHUNK_HEADER_SIZE <= this->data_size) {
+		const std::byte* const chunk = this->data + offset;
+		const size_t chunk_size = read_le<uint32_t>(chunk + 4);
+		const size_t body_offset = offset + CHUNK_HEADER_SIZE;
+		const size_t body_size = std::min(chunk_size, this->data_size - body_offset);
+
+		if (has_id(chunk, "fmt ") && body_size >= 16) {
+			const std::byte* const body = chunk + CHUNK_HEADER_SIZE;
+
+			format_tag = read_le<uint16_t>(body);
+			num_channels = read_le<uint16_t>(body + 2);
+			sample_rate = read_le<uint32_t>(body + 4);
+			block_align = read_le<uint16_t>(body + 12);
+			bits_per_sample = read_le<uint16_t>(body + 14);
+
+			if (format_tag == WAVE_FORMAT_EXTENSIBLE && body_size >= SUB_FORMAT_OFFSET + 2) {
+				format_tag = read_le<uint16_t>(body + SUB_FORMAT_OFFSET);
+			}
+
+			found_format = true;
+		} else if (has_id(chunk, "data")) {
+			if (!found_format || format_tag != WAVE_FORMAT_IEEE_FLOAT || bits_per_sample != 32 || num_channels == 0
+			    || block_align != num_channels * sizeof(dsp::sample_t)) {
+				return false;
+			}
+
+			// the samples must be aligned to be read in place
+			if (reinterpret_cast<uintptr_t>(chunk + CHUNK_HEADER_SIZE) % alignof(dsp::sample_t) != 0) {
+				return false;
+			}
+
+			// streaming writers may leave the data size unset, so the mapping bounds the data
+			this->view = dsp::SignalView<dsp::sample_t>(reinterpret_cast<const dsp::sample_t*>(chunk + CHUNK_HEADER_SIZE),
+			                                            body_size / block_align, num_channels, sample_rate);
+
+			return true;
+		}
+
+		// chunks are padded to an even size
+		offset = body_offset + chunk_size + (chunk_size & 1);
+	}
+
+	return false;
+}
+
+#ifdef _WIN32
+bool MappedAudioFile::map(const std::string& file_path) {
+	HANDLE file = CreateFileA(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+	                          FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	LARGE_INTEGER file_size;
+
+	if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	if (mapping == nullptr) {
+		CloseHandle(file);
+		return false;
+	}
+
+	const void* const view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+	if (view == nullptr) {
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	this->file_handle = file;
+	this->mapping_handle = mapping;
+	this->data = static_cast<const std::byte*>(view);
+	this->data_size = static_cast<size_t>(file_size.QuadPart);
+
+	return true;
+}
+
+void MappedAudioFile::unmap() {
+	if (this->data != nullptr) {
+		UnmapViewOfFile(this->data);
+		CloseHandle(static_cast<HANDLE>(this->mapping_handle));
+		CloseHandle(static_cast<HANDLE>(this->file_handle));
+	}
+
+	this->data = nullptr;
+	this->data_size = 0;
+	this->file_handle = nullptr;
+	this->mapping_handle = nullptr;
+}
+#else
+bool MappedAudioFile::map(const std::string& file_path) {
+	const int fd = ::open(file_path.c_str(), O_RDONLY);
+
+	if (fd < 0) {
+		return false;
+	}
+
+	struct stat file_stat;
+
+	if (fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0) {
+		::close(fd);
+		return false;
+	}
+
+	const size_t file_size = static_cast<size_t>(file_stat.st_size);
+	void* const view = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+
+	// the mapping keeps its own reference to the file
+	::close(fd);
+
+	if (view == MAP_FAILED) {
+		return false;
+	}
+
+	madvise(view, file_size, MADV_SEQUENTIAL);
+
+	this->data = static_cast<const std::byte*>(view);
+	this->data_size = file_size;
+
+	return true;
+}
+
+void MappedAudioFile::unmap() {
+	if (this->data != nullptr) {
+		munmap(const_cast<std::byte*>(this->data), this->data_size);
+	}
+
+	this->data = nullptr;
+	this->data_size = 0;
+}
+#endif
@@ -0,0 +1,184 @@
+#include "offline_renderer.hpp"
+
+#include <algorithm>
+#include <span>
+
+#include "block_ops.hpp"
+#include "tracing.hpp"
+
+OfflineRenderer::OfflineRenderer(const Config& config) :
+	config(config),
+	block(std::max<size_t>(config.block_frames, 1)),
+	file_buffer(std::max<size_t>(config.block_frames, 1) * dsp::NUM_CHANNELS)
+{ }
+
+bool OfflineRenderer::render(const dsp::PlanarSignal<dsp::sample_t>& input, dsp::PlanarSignal<dsp::sample_t>& output) {
+	return this->render_to_signal(input, input.sample_rate, input.num_frames(), input.num_channels(), output);
+}
+
+bool OfflineRenderer::render(const dsp::PlanarSignal<dsp::sample_t>& input, const std::string& output_path) {
+	return this->render_to_file(input, input.sample_rate, input.num_frames(), input.num_channels(), output_path);
+}
+
+bool OfflineRenderer::render(const dsp::SignalView<dsp::sample_t>& input, dsp::PlanarSignal<dsp::sample_t>& output) {
+	return this->render_to_signal(input, input.sample_rate, input.num_frames, input.num_channels, output);
+}
+
+bool OfflineRenderer::render(const dsp::SignalView<dsp::sample_t>& input, const std::string& output_path) {
+	return this->render_to_file(input, input.sample_rate, input.num_frames, input.num_channels, output_path);
+}
+
+bool OfflineRenderer::render(const std::string& input_path, const std::string& output_path) {
+	SF_INFO in_info = { };
+	SNDFILE* in_sf = sf_open(input_path.c_str(), SFM_READ, &in_info);
+
+	if (in_sf == nullptr) {
+		return false;
+	}
+
+	const size_t in_channels = static_cast<size_t>(in_info.channels);
+	const size_t out_channels = this->output_channels(in_channels);
+	SNDFILE* out_sf = this->open_output(output_path, static_cast<dsp::sample_rate_t>(in_info.samplerate), out_channels);
+
+	if (out_sf == nullptr) {
+		sf_close(in_sf);
+		return false;
+	}
+
+	// the file buffer holds a block in the layout of either file
+	this->file_buffer.resize(this->block.size() * std::max<size_t>(in_channels, dsp::NUM_CHANNELS));
+
+	bool success = true;
+
+	this->num_frames_rendered = 0;
+
+	while (success) {
+		const sf_count_t num_frames_read = sf_readf_float(in_sf, this->file_buffer.data(),
+		                                                  static_cast<sf_count_t>(this->block.size()));
+
+		if (num_frames_read <= 0) {
+			break;
+		}
+
+		const size_t len = static_cast<size_t>(num_frames_read);
+
+		dsp::read_interleaved(this->file_buffer.data(), in_channels,
+		                      std::span<dsp::Frame<dsp::sample_t>>(this->block.data(), len));
+		this->process_block(len, out_channels);
+		success = this->write_file(out_sf, len);
+	}
+
+	sf_close(in_sf);
+	sf_close(out_sf);
+
+	return success;
+}
+
+template<typename _input_t>
+bool OfflineRenderer::render_to_signal(const _input_t& input, const dsp::sample_rate_t sample_rate, const size_t num_frames,
+                                       const size_t num_channels, dsp::PlanarSignal<dsp::sample_t>& output) {
+	const size_t out_channels = this->output_channels(num_channels);
+
+	output = dsp::PlanarSignal<dsp::sample_t>(sample_rate, out_channels, num_frames);
+	this->num_frames_rendered = 0;
+
+	for (size_t offset = 0; offset < num_frames; offset += this->block.size()) {
+		const size_t len = std::min(this->block.size(), num_frames - offset);
+
+		dsp::read_wrapped(input, offset, std::span<dsp::Frame<dsp::sample_t>>(this->block.data(), len));
+		this->process_block(len, out_channels);
+		output.write_interleaved(this->file_buffer.data(), offset, len);
+		this->num_frames_rendered += len;
+	}
+
+	return true;
+}
+
+template<typename _input_t>
+bool OfflineRenderer::render_to_file(const _input_t& input, const dsp::sample_rate_t sample_rate, const size_t num_frames,
+                                     const size_t num_channels, const std::string& output_path) {
+	const size_t out_channels = this->output_channels(num_channels);
+	SNDFILE* sf = this->open_output(output_path, sample_rate, out_channels);
+
+	if (sf == nullptr) {
+		return false;
+	}
+
+	bool success = true;
+
+	this->num_frames_rendered = 0;
+
+	for (size_t offset = 0; offset < num_frames && success; offset += this->block.size()) {
+		const size_t len = std::min(this->block.size(), num_frames - offset);
+
+		dsp::read_wrapped(input, offset, std::span<dsp::Frame<dsp::sample_t>>(this->block.data(), len));
+		this->process_block(len, out_channels);
+		success = this->write_file(sf, len);
+	}
+
+	sf_close(sf);
+
+	return success;
+}
+
+void OfflineRenderer::reset() {
+	this->effects.reset();
+}
+
+const OfflineRenderer::Config& OfflineRenderer::get_config() const {
+	return this->config;
+}
+
+size_t OfflineRenderer::get_num_frames_rendered() const {
+	return this->num_frames_rendered;
+}
+
+size_t OfflineRenderer::output_channels(const size_t source_channels) const {
+	if (this->config.num_channels != 0) {
+		return this->config.num_channels;
+	}
+
+	return std::clamp<size_t>(source_channels, 1, dsp::NUM_CHANNELS);
+}
+
+void OfflineRenderer::process_block(const size_t num_frames, const size_t out_channels) {
+	STAC_TRACE_SCOPE("render_block", num_frames);
+	const std::span<dsp::Frame<dsp::sample_t>> frames(this->block.data(), num_frames);
+
+	if (this->file_buffer.size() < num_frames * out_channels) {
+		this->file_buffer.resize(num_frames * out_channels);
+	}
+
+	this->effects.process(frames);
+
+	// apply the gain while interleaving into the layout of the output
+	dsp::write_interleaved(std::span<const dsp::Frame<dsp::sample_t>>(frames), this->file_buffer.data(),
+	                       out_channels, this->gain);
+}
+
+bool OfflineRenderer::write_file(SNDFILE* sf, const size_t num_frames) {
+	const sf_count_t num_frames_written = sf_writef_float(sf, this->file_buffer.data(), static_cast<sf_count_t>(num_frames));
+
+	if (num_frames_written != static_cast<sf_count_t>(num_frames)) {
+		return false;
+	}
+
+	this->num_frames_rendered += num_frames;
+
+	return true;
+}
+
+SNDFILE* OfflineRenderer::open_output(const std::string& output_path, const dsp::sample_rate_t sample_rate,
+                                      const size_t num_channels) const {
+	SF_INFO sf_info = { };
+
+	sf_info.samplerate = static_cast<int>(sample_rate);
+	sf_info.channels = static_cast<int>(num_channels);
+	sf_info.format = this->config.format;
+
+	if (sf_format_check(&sf_info) == 0) {
+		return nullptr;
+	}
+
+	return sf_open(output_path.c_str(), SFM_WRITE, &sf_info);
+}
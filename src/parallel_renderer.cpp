@@ -0,0 +1,73 @@
+#include "parallel_renderer.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+ParallelRenderer::ParallelRenderer(const Config& config) :
+	config(config),
+	pool(config.num_threads)
+{ }
+
+std::vector<bool> ParallelRenderer::render_files(const std::vector<FileJob>& jobs, const configure_type& configure) {
+	// std::vector<bool> packs its elements into shared words, so each job writes its own byte
+	std::vector<uint8_t> results(jobs.size(), 0);
+
+	this->pool.parallel_for(jobs.size(), [&](const size_t i) {
+		OfflineRenderer renderer(this->config.render);
+
+		configure(renderer);
+		results[i] = renderer.render(jobs[i].input_path, jobs[i].output_path) ? 1 : 0;
+	});
+
+	return std::vector<bool>(results.begin(), results.end());
+}
+
+bool ParallelRenderer::render_chunked(const dsp::PlanarSignal<dsp::sample_t>& input, dsp::PlanarSignal<dsp::sample_t>& output,
+                                      const configure_type& configure) {
+	const size_t num_frames = input.num_frames();
+	const size_t in_channels = input.num_channels();
+	const size_t chunk_frames = std::max<size_t>(this->config.chunk_frames, 1);
+	const size_t num_chunks = (num_frames + chunk_frames - 1) / chunk_frames;
+	const size_t out_channels = OfflineRenderer(this->config.render).output_channels(in_channels);
+	std::atomic<bool> success = true;
+
+	output = dsp::PlanarSignal<dsp::sample_t>(input.sample_rate, out_channels, num_frames);
+
+	// every chunk writes a disjoint range of the output, so the result is the same for any thread count
+	this->pool.parallel_for(num_chunks, [&](const size_t chunk) {
+		const size_t start = chunk * chunk_frames;
+		const size_t end = std::min(start + chunk_frames, num_frames);
+		const size_t warm_up = std::min(this->config.warm_up_frames, start);
+		dsp::PlanarSignal<dsp::sample_t> chunk_input(input.sample_rate, in_channels, end - start + warm_up);
+		dsp::PlanarSignal<dsp::sample_t> chunk_output;
+		OfflineRenderer renderer(this->config.render);
+
+		for (size_t c = 0; c < in_channels; c++) {
+			std::copy(input.channels[c].begin() + static_cast<ptrdiff_t>(start - warm_up),
+			          input.channels[c].begin() + static_cast<ptrdiff_t>(end),
+			          chunk_input.channels[c].begin());
+		}
+
+		configure(renderer);
+
+		if (!renderer.render(chunk_input, chunk_output)) {
+			success.store(false);
+			return;
+		}
+
+		for (size_t c = 0; c < out_channels; c++) {
+			std::copy(chunk_output.channels[c].begin() + static_cast<ptrdiff_t>(warm_up), chunk_output.channels[c].end(),
+			          output.channels[c].begin() + static_cast<ptrdiff_t>(start));
+		}
+	});
+
+	return success.load();
+}
+
+const ParallelRenderer::Config& ParallelRenderer::get_config() const {
+	return this->config;
+}
+
+size_t ParallelRenderer::num_threads() const {
+	return this->pool.num_threads();
+}
@@ -0,0 +1,211 @@
+#include "streaming_source.hpp"
+
+#include <limits>
+
+#include "tracing.hpp"
+
+StreamingSource::~StreamingSource() {
+	this->close();
+}
+
+bool StreamingSource::open(const std::string& file_path, const size_t buffer_frames, const bool loop) {
+	this->close();
+
+	this->sf_info = { };
+	this->sf = sf_open(file_path.c_str(), SFM_READ, &this->sf_info);
+
+	if (this->sf == nullptr) {
+		return false;
+	}
+
+	// there is nothing to play, and a looping reader would rewind forever
+	if (this->num_frames() == 0 || this->num_channels() == 0) {
+		sf_close(this->sf);
+		this->sf = nullptr;
+		return false;
+	}
+
+	this->loop = loop;
+	this->ring_buffer = std::make_unique<dsp::RingBuffer<dsp::sample_t>>(std::max(buffer_frames, READ_BLOCK_FRAMES) * this->num_channels());
+	this->end_of_file.store(false);
+	this->seek_target.store(0);
+	this->seek_generation.store(0);
+	this->handled_generation.store(0);
+	this->flush_position.store(0);
+	this->num_underruns.store(0);
+	this->flushed_generation = 0;
+	this->frame_index = 0;
+
+	// decode the first block before returning so playback may begin on the first callback
+	this->fill(READ_BLOCK_FRAMES);
+
+	this->running.store(true);
+	this->reader_thread = std::thread(&StreamingSource::reader_loop, this);
+
+	return true;
+}
+
+void StreamingSource::close() {
+	if (this->reader_thread.joinable()) {
+		this->running.store(false);
+		this->notify_reader();
+		this->reader_thread.join();
+	}
+
+	if (this->sf != nullptr) {
+		sf_close(this->sf);
+		this->sf = nullptr;
+	}
+
+	this->ring_buffer.reset();
+}
+
+bool StreamingSource::is_open() const {
+	return this->sf != nullptr;
+}
+
+size_t StreamingSource::num_frames() const {
+	return static_cast<size_t>(this->sf_info.frames);
+}
+
+size_t StreamingSource::num_channels() const {
+	return static_cast<size_t>(this->sf_info.channels);
+}
+
+dsp::sample_rate_t StreamingSource::sample_rate() const {
+	return static_cast<dsp::sample_rate_t>(this->sf_info.samplerate);
+}
+
+uint64_t StreamingSource::underrun_count() const {
+	return this->num_underruns.load(std::memory_order_relaxed);
+}
+
+bool StreamingSource::is_finished() const {
+	if (!this->is_open()) {
+		return false;
+	}
+
+	// the end of file flag is not cleared until the reader handles a pending seek
+	if (this->handled_generation.load(std::memory_order_acquire) != this->seek_generation.load(std::memory_order_relaxed)) {
+		return false;
+	}
+
+	return this->end_of_file.load(std::memory_order_acquire) && this->ring_buffer->size() == 0;
+}
+
+bool StreamingSource::seek(const size_t frame_index) {
+	if (frame_index >= this->num_frames()) {
+		return false;
+	}
+
+	this->seek_target.store(frame_index, std::memory_order_relaxed);
+	this->seek_generation.fetch_add(1, std::memory_order_release);
+	this->frame_index = frame_index;
+
+	this->notify_reader();
+
+	return true;
+}
+
+size_t StreamingSource::position() const {
+	return this->frame_index;
+}
+
+bool StreamingSource::is_seek_complete() {
+	const uint32_t requested_generation = this->seek_generation.load(std::memory_order_relaxed);
+
+	if (this->handled_generation.load(std::memory_order_acquire) != requested_generation) {
+		return false;
+	}
+
+	if (this->flushed_generation != requested_generation) {
+		this->ring_buffer->discard_until(this->flush_position.load(std::memory_order_relaxed));
+		this->flushed_generation = requested_generation;
+	}
+
+	return true;
+}
+
+void StreamingSource::advance(const size_t num_frames) {
+	this->frame_index += num_frames;
+
+	if (this->loop && this->frame_index >= this->num_frames()) {
+		this->frame_index -= this->num_frames();
+	}
+}
+
+void StreamingSource::notify_reader() {
+	if (!this->wake_reader.exchange(true, std::memory_order_release)) {
+		this->wake_reader.notify_one();
+	}
+}
+
+size_t StreamingSource::fill(const size_t max_frames) {
+	const size_t num_channels = this->num_channels();
+	size_t total_frames_read = 0;
+	// whether the file has been rewound without any frames being read since
+	bool rewound = false;
+
+	while (total_frames_read < max_frames && !this->end_of_file.load(std::memory_order_relaxed)) {
+		// stop early so that a pending seek is not delayed by a whole buffer of decoding
+		if (this->seek_generation.load(std::memory_order_relaxed) != this->handled_generation.load(std::memory_order_relaxed)) {
+			break;
+		}
+
+		const std::span<dsp::sample_t> region = this->ring_buffer->write_region();
+		// decode straight into the ring buffer rather than through an intermediate buffer
+		const sf_count_t num_frames_to_read = static_cast<sf_count_t>(std::min({ region.size() / num_channels, READ_BLOCK_FRAMES, max_frames - total_frames_read }));
+
+		if (num_frames_to_read == 0) {
+			break;
+		}
+
+		STAC_TRACE_SCOPE("file_read", num_frames_to_read);
+		const sf_count_t curr_frames_read = sf_readf_float(this->sf, region.data(), num_frames_to_read);
+
+		if (curr_frames_read > 0) {
+			this->ring_buffer->commit_write(static_cast<size_t>(curr_frames_read) * num_channels);
+			total_frames_read += static_cast<size_t>(curr_frames_read);
+			rewound = false;
+		}
+
+		if (curr_frames_read < num_frames_to_read) {
+			// a file that yields nothing right after a rewind would otherwise be rewound forever
+			if (this->loop && !(rewound && curr_frames_read <= 0) && sf_seek(this->sf, 0, SEEK_SET) == 0) {
+				rewound = true;
+				continue;
+			}
+
+			this->end_of_file.store(true, std::memory_order_release);
+		}
+	}
+
+	return total_frames_read;
+}
+
+void StreamingSource::reader_loop() {
+	uint32_t curr_generation = 0;
+
+	STAC_TRACE_THREAD("stream_reader");
+
+	while (this->running.load(std::memory_order_acquire)) {
+		// clear the flag before doing work so that a wake up during the work is not missed
+		this->wake_reader.store(false, std::memory_order_relaxed);
+
+		const uint32_t requested_generation = this->seek_generation.load(std::memory_order_acquire);
+
+		if (requested_generation != curr_generation) {
+			const sf_count_t target = static_cast<sf_count_t>(this->seek_target.load(std::memory_order_relaxed));
+
+			sf_seek(this->sf, target, SEEK_SET);
+			this->end_of_file.store(false, std::memory_order_relaxed);
+			this->flush_position.store(this->ring_buffer->write_position(), std::memory_order_relaxed);
+			this->handled_generation.store(requested_generation, std::memory_order_release);
+			curr_generation = requested_generation;
+		}
+
+		this->fill(std::numeric_limits<size_t>::max());
+
+		this->wake_reader.wait(false, std::memory_order_acquire);
+	}
+}
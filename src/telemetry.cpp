@@ -0,0 +1,132 @@
+#include "telemetry.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+CallbackTelemetry::CallbackTelemetry(const size_t capacity) :
+	records(capacity)
+{ }
+
+bool CallbackTelemetry::push(const CallbackRecord& record) {
+	if (this->records.write(&record, 1) == 1) {
+		return true;
+	}
+
+	this->num_dropped.fetch_add(1, std::memory_order_relaxed);
+
+	return false;
+}
+
+size_t CallbackTelemetry::read(std::span<CallbackRecord> destination) {
+	return this->records.read(destination.data(), destination.size());
+}
+
+uint64_t CallbackTelemetry::dropped_count() const {
+	return this->num_dropped.load(std::memory_order_relaxed);
+}
+
+Histogram::Histogram(const double bucket_width, const size_t num_buckets) :
+	bucket_width(bucket_width),
+	buckets(num_buckets, 0)
+{ }
+
+void Histogram::add(const double value) {
+	const double index = std::floor(value / this->bucket_width);
+	const size_t bucket = (index <= 0.0) ? 0 : std::min(static_cast<size_t>(index), this->buckets.size() - 1);
+
+	this->buckets[bucket]++;
+	this->num_values++;
+	this->sum += value;
+	this->max_value = (this->num_values == 1) ? value : std::max(this->max_value, value);
+}
+
+void Histogram::reset() {
+	std::fill(this->buckets.begin(), this->buckets.end(), 0);
+	this->num_values = 0;
+	this->sum = 0.0;
+	this->max_value = 0.0;
+}
+
+uint64_t Histogram::count() const {
+	return this->num_values;
+}
+
+double Histogram::mean() const {
+	return (this->num_values > 0) ? this->sum / static_cast<double>(this->num_values) : 0.0;
+}
+
+double Histogram::max() const {
+	return this->max_value;
+}
+
+double Histogram::percentile(const double percentile) const {
+	if (this->num_values == 0) {
+		return 0.0;
+	}
+
+	const double rank = std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * static_cast<double>(this->num_values));
+	const uint64_t target = std::max<uint64_t>(static_cast<uint64_t>(rank), 1);
+	uint64_t num_seen = 0;
+
+	for (size_t i = 0; i < this->buckets.size(); i++) {
+		num_seen += this->buckets[i];
+
+		if (num_seen >= target) {
+			return static_cast<double>(i + 1) * this->bucket_width;
+		}
+	}
+
+	return static_cast<double>(this->buckets.size()) * this->bucket_width;
+}
+
+double Histogram::get_bucket_width() const {
+	return this->bucket_width;
+}
+
+const std::vector<uint64_t>& Histogram::get_buckets() const {
+	return this->buckets;
+}
+
+void CallbackStats::add(const CallbackRecord& record) {
+	this->cpu_time_us.add(static_cast<double>(record.cpu_time_ns) / 1000.0);
+
+	if (record.buffer_period_ns > 0) {
+		this->load.add(static_cast<double>(record.cpu_time_ns) / static_cast<double>(record.buffer_period_ns));
+	}
+
+	if (record.time_to_dac_ns > 0) {
+		this->min_slack_ns = std::min(this->min_slack_ns, record.time_to_dac_ns - static_cast<int64_t>(record.cpu_time_ns));
+	}
+
+	if ((record.status_flags & paOutputUnderflow) != 0) {
+		this->num_output_underflows++;
+	}
+
+	if ((record.status_flags & paOutputOverflow) != 0) {
+		this->num_output_overflows++;
+	}
+
+	this->num_callbacks++;
+	this->sample_index = record.sample_index;
+}
+
+size_t CallbackStats::collect(CallbackTelemetry& telemetry) {
+	std::array<CallbackRecord, 256> records;
+	size_t num_collected = 0;
+	size_t num_read;
+
+	while ((num_read = telemetry.read(records)) > 0) {
+		for (size_t i = 0; i < num_read; i++) {
+			this->add(records[i]);
+		}
+
+		num_collected += num_read;
+	}
+
+	return num_collected;
+}
+
+void CallbackStats::reset() {
+	*this = CallbackStats();
+}
@@ -0,0 +1,140 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+
+#include "tracing.hpp"
+
+namespace {
+/// Pool and worker index of the calling thread, so that tasks submitted by a task
+/// go to the deque of the worker running it
+thread_local const ThreadPool* t_pool   = nullptr;
+thread_local size_t            t_worker = 0;
+}
+
+ThreadPool::ThreadPool(const size_t num_threads) {
+	const size_t count = (num_threads != 0) ? num_threads : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+	for (size_t i = 0; i < count; i++) {
+		this->workers.push_back(std::make_unique<Worker>());
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		this->threads.emplace_back(&ThreadPool::worker_loop, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	this->wait();
+
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->stopping = true;
+	}
+
+	this->work_cv.notify_all();
+
+	for (std::thread& thread : this->threads) {
+		thread.join();
+	}
+}
+
+size_t ThreadPool::num_threads() const {
+	return this->threads.size();
+}
+
+void ThreadPool::submit(task_type task) {
+	const size_t index = (t_pool == this) ? t_worker :
+	                     this->next_worker.fetch_add(1, std::memory_order_relaxed) % this->workers.size();
+	Worker& worker = *this->workers[index];
+
+	this->num_pending.fetch_add(1, std::memory_order_relaxed);
+
+	{
+		std::lock_guard<std::mutex> lock(worker.mutex);
+		worker.tasks.push_back(std::move(task));
+	}
+
+	{
+		// incremented under the mutex so that a worker that is about to sleep sees it
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->num_queued.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	this->work_cv.notify_one();
+}
+
+void ThreadPool::wait() {
+	std::unique_lock<std::mutex> lock(this->mutex);
+
+	this->idle_cv.wait(lock, [this] { return this->num_pending.load() == 0; });
+}
+
+void ThreadPool::parallel_for(const size_t count, const std::function<void(size_t)>& fn) {
+	for (size_t i = 0; i < count; i++) {
+		this->submit([&fn, i] { fn(i); });
+	}
+
+	this->wait();
+}
+
+void ThreadPool::worker_loop(const size_t index) {
+	t_pool = this;
+	t_worker = index;
+
+	STAC_TRACE_THREAD("worker");
+
+	task_type task;
+
+	while (true) {
+		if (this->try_pop(index, task)) {
+			this->run(task);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(this->mutex);
+
+		this->work_cv.wait(lock, [this] { return this->stopping || this->num_queued.load() > 0; });
+
+		if (this->stopping && this->num_queued.load() == 0) {
+			return;
+		}
+	}
+}
+
+bool ThreadPool::try_pop(const size_t index, task_type& task) {
+	const size_t num_workers = this->workers.size();
+
+	// newest task of our own deque first, then the oldest task of the others
+	for (size_t i = 0; i < num_workers; i++) {
+		Worker& worker = *this->workers[(index + i) % num_workers];
+		std::lock_guard<std::mutex> lock(worker.mutex);
+
+		if (worker.tasks.empty()) {
+			continue;
+		}
+
+		if (i == 0) {
+			task = std::move(worker.tasks.back());
+			worker.tasks.pop_back();
+		} else {
+			task = std::move(worker.tasks.front());
+			worker.tasks.pop_front();
+		}
+
+		this->num_queued.fetch_sub(1, std::memory_order_relaxed);
+
+		return true;
+	}
+
+	return false;
+}
+
+void ThreadPool::run(task_type& task) {
+	task();
+	task = nullptr;
+
+	if (this->num_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->idle_cv.notify_all();
+	}
+}
@@ -0,0 +1,284 @@
+#include "tracing.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <utility>
+
+namespace dsp::trace {
+/**
+ * @brief Slot of the calling thread. Hands the slot back when the thread exits
+ */
+struct ThreadTraceOwner {
+	ThreadTrace* trace      = nullptr;
+	size_t       slot_index = 0;
+	/// Whether the thread tried to take a slot and found every slot taken
+	bool         unregistered = false;
+
+	~ThreadTraceOwner() {
+		if (this->trace != nullptr) {
+			Tracer::instance().release(this->slot_index);
+		}
+	}
+};
+
+namespace {
+thread_local ThreadTraceOwner t_owner;
+
+/**
+ * @brief Write a string as a JSON string, escaping what JSON requires
+ */
+void write_json_string(std::ostream& os, const char* str) {
+	os << '"';
+
+	for (; *str != '\0'; str++) {
+		const char c = *str;
+
+		if (c == '"' || c == '\\') {
+			os << '\\' << c;
+		} else if (static_cast<unsigned char>(c) < 0x20) {
+			static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+			os << "\\u00" << HEX_DIGITS[(c >> 4) & 0xf] << HEX_DIGITS[c & 0xf];
+		} else {
+			os << c;
+		}
+	}
+
+	os << '"';
+}
+
+/**
+ * @brief Write nanoseconds as the fractional microseconds of Chrome trace timestamps
+ */
+void write_us(std::ostream& os, const uint64_t ns) {
+	const uint64_t fraction = ns % 1000;
+
+	os << ns / 1000 << '.' << static_cast<char>('0' + fraction / 100) << static_cast<char>('0' + fraction / 10 % 10)
+	   << static_cast<char>('0' + fraction % 10);
+}
+} // namespace
+
+Tracer::~Tracer() {
+	for (Slot& slot : this->slots) {
+		delete slot.trace.load(std::memory_order_acquire);
+	}
+}
+
+ThreadTrace* Tracer::register_thread(const char* name) {
+	if (t_owner.trace != nullptr || t_owner.unregistered) {
+		return t_owner.trace;
+	}
+
+	ThreadTrace* trace = this->claim_slot(name);
+
+	if (trace == nullptr) {
+		// hand back the slots of threads that have exited and try again
+		this->collect();
+		trace = this->claim_slot(name);
+	}
+
+	t_owner.unregistered = (trace == nullptr);
+
+	return trace;
+}
+
+void Tracer::reserve(const size_t num_threads) {
+	size_t num_reserved = 0;
+
+	for (size_t i = 0; i < MAX_THREADS && num_reserved < num_threads; i++) {
+		Slot& slot = this->slots[i];
+		SlotState expected = SlotState::FREE;
+
+		if (!slot.state.compare_exchange_strong(expected, SlotState::CLAIMED, std::memory_order_acquire)) {
+			continue;
+		}
+
+		if (slot.trace.load(std::memory_order_relaxed) == nullptr) {
+			slot.trace.store(new ThreadTrace(DEFAULT_CAPACITY), std::memory_order_relaxed);
+		}
+
+		slot.state.store(SlotState::FREE, std::memory_order_release);
+		num_reserved++;
+	}
+}
+
+ThreadTrace* Tracer::claim_slot(const char* name) {
+	// first pass takes a slot with a buffer so that nothing is allocated, the second any free slot
+	for (const bool need_buffer : { true, false }) {
+		for (size_t i = 0; i < MAX_THREADS; i++) {
+			Slot& slot = this->slots[i];
+			SlotState expected = SlotState::FREE;
+
+			if (need_buffer && slot.trace.load(std::memory_order_relaxed) == nullptr) {
+				continue;
+			}
+
+			if (slot.state.load(std::memory_order_relaxed) != SlotState::FREE ||
+			    !slot.state.compare_exchange_strong(expected, SlotState::CLAIMED, std::memory_order_acquire)) {
+				continue;
+			}
+
+			ThreadTrace* trace = slot.trace.load(std::memory_order_relaxed);
+
+			if (trace == nullptr) {
+				trace = new ThreadTrace(DEFAULT_CAPACITY);
+				slot.trace.store(trace, std::memory_order_relaxed);
+			}
+
+			trace->id = this->next_thread_id.fetch_add(1, std::memory_order_relaxed);
+			trace->name = name;
+			// publishes the id and name along with the buffer
+			slot.state.store(SlotState::ACTIVE, std::memory_order_release);
+
+			t_owner.trace = trace;
+			t_owner.slot_index = i;
+
+			return trace;
+		}
+	}
+
+	return nullptr;
+}
+
+void Tracer::release(const size_t slot_index) {
+	this->slots[slot_index].state.store(SlotState::RELEASED, std::memory_order_release);
+}
+
+void Tracer::record(const TraceEvent& event) {
+	ThreadTrace* const thread_trace = (t_owner.trace != nullptr) ? t_owner.trace : this->register_thread();
+
+	if (thread_trace == nullptr) {
+		this->num_unregistered_dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	if (thread_trace->events.write(&event, 1) == 0) {
+		thread_trace->num_dropped.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+size_t Tracer::collect() {
+	std::lock_guard<std::mutex> lock(this->collect_mutex);
+
+	return this->collect_locked();
+}
+
+size_t Tracer::collect_locked() {
+	size_t num_collected = 0;
+
+	for (size_t i = 0; i < MAX_THREADS; i++) {
+		Slot& slot = this->slots[i];
+		const SlotState state = slot.state.load(std::memory_order_acquire);
+
+		// free slots have nothing to collect, and claimed ones are not set up yet
+		if (state != SlotState::ACTIVE && state != SlotState::RELEASED) {
+			continue;
+		}
+
+		ThreadTrace* const thread_trace = slot.trace.load(std::memory_order_relaxed);
+
+		if (this->named_ids[i] != thread_trace->id) {
+			this->thread_names.emplace_back(thread_trace->id, thread_trace->name);
+			this->named_ids[i] = thread_trace->id;
+		}
+
+		std::span<const TraceEvent> region = thread_trace->events.read_region();
+
+		while (!region.empty()) {
+			for (const TraceEvent& event : region) {
+				this->collected.emplace_back(thread_trace->id, event);
+			}
+
+			thread_trace->events.commit_read(region.size());
+			num_collected += region.size();
+			region = thread_trace->events.read_region();
+		}
+
+		// the thread had exited before the buffer was drained, so the buffer is empty for good
+		if (state == SlotState::RELEASED) {
+			this->num_released_dropped.fetch_add(thread_trace->num_dropped.exchange(0, std::memory_order_relaxed),
+			                                     std::memory_order_relaxed);
+			slot.state.store(SlotState::FREE, std::memory_order_release);
+		}
+	}
+
+	return num_collected;
+}
+
+void Tracer::clear() {
+	std::lock_guard<std::mutex> lock(this->collect_mutex);
+
+	this->collected.clear();
+}
+
+uint64_t Tracer::dropped_count() const {
+	uint64_t num_dropped = this->num_unregistered_dropped.load(std::memory_order_relaxed) +
+	                       this->num_released_dropped.load(std::memory_order_relaxed);
+
+	for (const Slot& slot : this->slots) {
+		const ThreadTrace* const thread_trace = slot.trace.load(std::memory_order_acquire);
+
+		if (thread_trace != nullptr) {
+			num_dropped += thread_trace->num_dropped.load(std::memory_order_relaxed);
+		}
+	}
+
+	return num_dropped;
+}
+
+void Tracer::write_chrome_trace(std::ostream& os) {
+	std::lock_guard<std::mutex> lock(this->collect_mutex);
+	bool first = true;
+
+	this->collect_locked();
+
+	const auto separate = [&os, &first] {
+		os << (first ? "\n" : ",\n");
+		first = false;
+	};
+
+	os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+	for (const auto& [tid, name] : this->thread_names) {
+		separate();
+		os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid << ",\"args\":{\"name\":";
+		write_json_string(os, name);
+		os << "}}";
+	}
+
+	for (const auto& [tid, event] : this->collected) {
+		separate();
+		os << "{\"name\":";
+		write_json_string(os, event.name);
+		os << ",\"cat\":\"stac_audio\",\"pid\":1,\"tid\":" << tid << ",\"ts\":";
+		write_us(os, event.start_ns);
+
+		if (event.type == EventType::SCOPE) {
+			os << ",\"ph\":\"X\",\"dur\":";
+			write_us(os, event.duration_ns);
+
+			if (event.value != NO_ARG) {
+				os << ",\"args\":{\"arg\":" << event.value << '}';
+			}
+		} else {
+			os << ",\"ph\":\"C\",\"args\":{\"value\":" << event.value << '}';
+		}
+
+		os << '}';
+	}
+
+	os << "\n]}\n";
+}
+
+bool Tracer::write_chrome_trace(const std::string& file_path) {
+	std::ofstream file(file_path);
+
+	if (!file) {
+		return false;
+	}
+
+	this->write_chrome_trace(file);
+
+	return static_cast<bool>(file);
+}
+} // namespace dsp::trace
@@ -0,0 +1,87 @@
+#include <iostream>
+#include <cmath>
+#include <memory>
+
+#include <stac_audio/signals.hpp>
+#include <stac_audio/offline_renderer.hpp>
+#include <stac_audio/parallel_renderer.hpp>
+#include <stac_audio/biquad_effect.hpp>
+
+// renders a signal in chunks with one thread and with several, and checks that the
+// results are bit-exact with each other and match a sequential render up to the
+// error the warm-up leaves at the joins
+static constexpr dsp::sample_rate_t SAMPLE_RATE  = 48000;
+static constexpr size_t             NUM_FRAMES   = 200000;
+static constexpr size_t             NUM_CHANNELS = 2;
+static constexpr dsp::sample_t      TOLERANCE    = 1e-5f;
+
+static void add_low_pass(OfflineRenderer& renderer) {
+	renderer.effects.add(std::make_shared<BiquadEffect<dsp::sample_t>>(
+		dsp::BiquadType::LOW_PASS, SAMPLE_RATE, 2000.0f, 0.707, 0.0));
+}
+
+static bool render_chunked(const dsp::PlanarSignal<dsp::sample_t>& input, dsp::PlanarSignal<dsp::sample_t>& output,
+                           const size_t num_threads) {
+	ParallelRenderConfig config;
+
+	config.num_threads = num_threads;
+	config.chunk_frames = 16384;
+	config.warm_up_frames = 8192;
+
+	ParallelRenderer renderer(config);
+
+	return renderer.render_chunked(input, output, add_low_pass);
+}
+
+int main() {
+	dsp::PlanarSignal<dsp::sample_t> input(SAMPLE_RATE, NUM_CHANNELS, NUM_FRAMES);
+	dsp::PlanarSignal<dsp::sample_t> sequential;
+	dsp::PlanarSignal<dsp::sample_t> single_threaded;
+	dsp::PlanarSignal<dsp::sample_t> multi_threaded;
+	OfflineRenderer renderer;
+	uint32_t noise = 1;
+
+	for (size_t c = 0; c < NUM_CHANNELS; c++) {
+		for (size_t i = 0; i < NUM_FRAMES; i++) {
+			noise = noise * 1664525u + 1013904223u;
+			input.channels[c][i] = 0.5f * std::sin(static_cast<dsp::sample_t>(i) * 0.01f * static_cast<dsp::sample_t>(c + 1))
+				+ 0.25f * (static_cast<dsp::sample_t>(noise >> 8) / static_cast<dsp::sample_t>(1 << 24) - 0.5f);
+		}
+	}
+
+	add_low_pass(renderer);
+
+	if (!renderer.render(input, sequential) || !render_chunked(input, single_threaded, 1)
+		|| !render_chunked(input, multi_threaded, 8)) {
+		std::cout << "Render failed\n";
+		return 1;
+	}
+
+	if (single_threaded.num_channels() != NUM_CHANNELS || multi_threaded.num_channels() != NUM_CHANNELS
+		|| single_threaded.num_frames() != NUM_FRAMES || multi_threaded.num_frames() != NUM_FRAMES) {
+		std::cout << "Rendered signal has the wrong shape\n";
+		return 1;
+	}
+
+	dsp::sample_t max_error = 0;
+
+	for (size_t c = 0; c < NUM_CHANNELS; c++) {
+		if (single_threaded.channels[c] != multi_threaded.channels[c]) {
+			std::cout << "Channel " << c << " differs between 1 and 8 threads\n";
+			return 1;
+		}
+
+		for (size_t i = 0; i < NUM_FRAMES; i++) {
+			max_error = std::max(max_error, std::abs(single_threaded.channels[c][i] - sequential.channels[c][i]));
+		}
+	}
+
+	if (max_error > TOLERANCE) {
+		std::cout << "Chunked render differs from the sequential render by " << max_error << "\n";
+		return 1;
+	}
+
+	std::cout << "Chunked renders match, maximum error against the sequential render: " << max_error << "\n";
+
+	return 0;
+}
@@ -0,0 +1,61 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <charconv>
+
+#include <stac_audio/fft_wisdom.hpp>
+
+/*
+ * Plans the given fftw transform sizes with FFTW_PATIENT and caches the wisdom,
+ * so that services using stac_audio load PATIENT plans without measuring them.
+ * Intended to be run once per machine, e.g. at install time.
+ *
+ * Usage: stac_audio_wisdom [--double] [--interleaved] [--dir <directory>] [size...]
+ */
+int main(int argc, char** argv) {
+	static constexpr size_t DEFAULT_SIZES[] = { 256, 512, 1024, 2048, 4096, 8192 };
+	std::vector<size_t> sizes;
+	std::vector<size_t> strides = { 1 };
+	std::filesystem::path directory = dsp::fft::default_wisdom_directory();
+	bool plan_double = false;
+
+	for (int i = 1; i < argc; i++) {
+		const std::string arg = argv[i];
+
+		if (arg == "--double") {
+			plan_double = true;
+		} else if (arg == "--interleaved") {
+			// a single channel of an interleaved stereo buffer
+			strides.push_back(2);
+		} else if (arg == "--dir" && i + 1 < argc) {
+			directory = argv[++i];
+		} else {
+			size_t size = 0;
+			const std::from_chars_result result = std::from_chars(arg.data(), arg.data() + arg.size(), size);
+
+			if (result.ec != std::errc() || size == 0) {
+				std::cout << "Invalid transform size: " << arg << "\n";
+				return 1;
+			}
+
+			sizes.push_back(size);
+		}
+	}
+
+	if (sizes.empty()) {
+		sizes.assign(std::begin(DEFAULT_SIZES), std::end(DEFAULT_SIZES));
+	}
+
+	std::cout << "Planning " << sizes.size() << " sizes for " << dsp::fft::cpu_identifier() << "\n";
+
+	bool success = dsp::fft::preplan<float>(sizes, strides, FFTW_PATIENT, directory);
+	std::cout << dsp::fft::wisdom_file_path<float>(directory).string() << (success ? "" : " (failed)") << "\n";
+
+	if (plan_double) {
+		const bool double_success = dsp::fft::preplan<double>(sizes, strides, FFTW_PATIENT, directory);
+		std::cout << dsp::fft::wisdom_file_path<double>(directory).string() << (double_success ? "" : " (failed)") << "\n";
+		success = success && double_success;
+	}
+
+	return success ? 0 : 1;
+}